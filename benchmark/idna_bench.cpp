@@ -0,0 +1,165 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <skyr/domain/domain.hpp>
+#include <skyr/domain/domain_cache.hpp>
+#include <skyr/domain/idna.hpp>
+#include <skyr/unicode/ranges/transforms/u32_transform.hpp>
+#include <skyr/unicode/ranges/views/u8_view.hpp>
+
+namespace {
+struct host_set {
+  std::string_view name;
+  std::vector<std::string> hosts;
+};
+
+// Hosts whose labels are mostly non-ASCII, so that IDNA processing is dominated by table lookups
+const std::vector<host_set> host_sets = {
+    {"CJK",
+     {
+         "例子.测试",
+         "中国互联网络信息中心.中国",
+         "ドメイン名例.jp",
+         "日本語ドメイン.テスト",
+         "한국인터넷진흥원.한국",
+         "香港特別行政區政府.香港",
+     }},
+    {"Arabic",
+     {
+         "مثال.إختبار",
+         "وزارة-الاتصالات.مصر",
+         "الاتصالات-وتقنية-المعلومات.السعودية",
+         "موقع.وزارة-الاتصالات.مصر",
+         "مثال.امارات",
+     }},
+    {"Emoji",
+     {
+         "i❤️.ws",
+         "😀😃😄.example",
+         "🍕🍔🍟.com",
+         "☃️-⌘.com",
+         "🇺🇳🇫🇷.ws",
+     }},
+};
+
+struct benchmark_result {
+  std::string_view name;
+  std::size_t hosts_processed;
+  double avg_ns_per_host;
+  std::size_t checksum;
+};
+
+template <class Process>
+auto run_benchmark(std::string_view name, std::size_t host_count, std::size_t iterations, Process process)
+    -> benchmark_result {
+  std::size_t checksum = 0;
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for (std::size_t i = 0; i < iterations; ++i) {
+    // Accumulate the output to prevent dead code elimination
+    checksum += process();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+  auto total_hosts = iterations * host_count;
+  auto avg_ns = static_cast<double>(duration_ns) / static_cast<double>(total_hosts);
+
+  return {name, total_hosts, avg_ns, checksum};
+}
+
+void print_result(std::string_view set_name, const benchmark_result& result) {
+  std::cout << "  " << std::left << std::setw(8) << set_name << std::setw(28) << result.name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10) << result.avg_ns_per_host << " ns/host" << std::setprecision(0)
+            << std::setw(14) << (1'000'000'000.0 / result.avg_ns_per_host) << " hosts/second\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t iterations = 100'000;
+
+  if (argc > 1) {
+    try {
+      iterations = std::stoull(argv[1]);
+    } catch (...) {
+      std::cerr << "Usage: " << argv[0] << " [iterations]\n";
+      std::cerr << "  iterations: number of times to process all test hosts (default: 100000)\n";
+      return 1;
+    }
+  }
+
+  std::cout << "Running IDNA benchmark...\n";
+  std::cout << "\n=================================================\n";
+  std::cout << "IDNA Benchmark Results\n";
+  std::cout << "=================================================\n\n";
+  std::cout << "Configuration:\n";
+  std::cout << "  Iterations:    " << iterations << "\n\n";
+  std::cout << "Performance:\n";
+
+  for (const auto& [set_name, hosts] : host_sets) {
+    auto code_points = std::vector<std::u32string>{};
+    for (const auto& host : hosts) {
+      auto u32_host =
+          skyr::unicode::as<std::u32string>(skyr::unicode::views::as_u8(host) | skyr::unicode::transforms::to_u32);
+      code_points.push_back(u32_host.value());
+    }
+
+    // The status and mapping lookups alone, for every code point of each host
+    print_result(set_name, run_benchmark("code_point_status", hosts.size(), iterations, [&code_points]() {
+                   std::size_t sum = 0;
+                   for (const auto& host : code_points) {
+                     for (auto code_point : host) {
+                       sum += static_cast<std::size_t>(skyr::idna::code_point_status(code_point));
+                     }
+                   }
+                   return sum;
+                 }));
+    print_result(set_name, run_benchmark("map_code_point", hosts.size(), iterations, [&code_points]() {
+                   std::size_t sum = 0;
+                   for (const auto& host : code_points) {
+                     for (auto code_point : host) {
+                       sum += skyr::idna::map_code_point(code_point).size();
+                     }
+                   }
+                   return sum;
+                 }));
+
+    // The full conversion, including Punycode encoding
+    auto ascii_host = std::string{};
+    print_result(set_name, run_benchmark("domain_to_ascii", hosts.size(), iterations, [&hosts, &ascii_host]() {
+                   std::size_t sum = 0;
+                   for (const auto& host : hosts) {
+                     ascii_host.clear();
+                     if (skyr::domain_to_ascii(host, &ascii_host)) {
+                       sum += ascii_host.size();
+                     }
+                   }
+                   return sum;
+                 }));
+
+    // The same conversion, when the results are cached
+    auto cache = skyr::domain_cache(1'024);
+    print_result(set_name, run_benchmark("domain_cache::to_ascii", hosts.size(), iterations, [&]() {
+                   std::size_t sum = 0;
+                   for (const auto& host : hosts) {
+                     ascii_host.clear();
+                     if (cache.to_ascii(host, &ascii_host)) {
+                       sum += ascii_host.size();
+                     }
+                   }
+                   return sum;
+                 }));
+  }
+
+  std::cout << "\n=================================================\n";
+  return 0;
+}
@@ -0,0 +1,122 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <skyr/public_suffix/public_suffix_list.hpp>
+
+namespace {
+// Hosts with public suffixes of different lengths, including wildcard and exception rules
+const std::vector<std::string_view> hosts = {
+    "www.example.com",
+    "example.co.uk",
+    "a.b.c.example.co.uk",
+    "www.city.kobe.jp",
+    "foo.bar.kobe.jp",
+    "user.github.io",
+    "www.wikipedia.org",
+    "mail.google.com",
+    "xn--fsqu00a.xn--0zwm56d",
+    "shishi.xn--55qx5d.cn",
+    "static.cdn.example.net",
+    "www.example.unlisted",
+};
+
+struct benchmark_result {
+  std::string_view name;
+  std::size_t hosts_processed;
+  double avg_ns_per_host;
+  std::size_t checksum;
+};
+
+template <class Process>
+auto run_benchmark(std::string_view name, std::size_t iterations, Process process) -> benchmark_result {
+  std::size_t checksum = 0;
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for (std::size_t i = 0; i < iterations; ++i) {
+    for (const auto& host : hosts) {
+      // Accumulate the output to prevent dead code elimination
+      checksum += process(host);
+    }
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+  auto total_hosts = iterations * hosts.size();
+  auto avg_ns = static_cast<double>(duration_ns) / static_cast<double>(total_hosts);
+
+  return {name, total_hosts, avg_ns, checksum};
+}
+
+void print_result(const benchmark_result& result) {
+  std::cout << "  " << std::left << std::setw(22) << result.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << result.avg_ns_per_host << " ns/host" << std::setprecision(0) << std::setw(14)
+            << (1'000'000'000.0 / result.avg_ns_per_host) << " hosts/second\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t iterations = 1'000'000;
+
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " public_suffix_list.dat [iterations]\n";
+    std::cerr << "  iterations: number of times to process all test hosts (default: 1000000)\n";
+    return 1;
+  }
+  if (argc > 2) {
+    try {
+      iterations = std::stoull(argv[2]);
+    } catch (...) {
+      std::cerr << "Usage: " << argv[0] << " public_suffix_list.dat [iterations]\n";
+      return 1;
+    }
+  }
+
+  std::cout << "Running public suffix benchmark...\n";
+
+  auto start = std::chrono::high_resolution_clock::now();
+  auto list = skyr::public_suffix_list::load(argv[1]);
+  auto end = std::chrono::high_resolution_clock::now();
+  if (!list) {
+    std::cerr << "Unable to load " << argv[1] << "\n";
+    return 1;
+  }
+
+  std::cout << "\n=================================================\n";
+  std::cout << "Public Suffix Benchmark Results\n";
+  std::cout << "=================================================\n\n";
+  std::cout << "Configuration:\n";
+  std::cout << "  Iterations:    " << iterations << "\n";
+  std::cout << "  Hosts:         " << hosts.size() << "\n\n";
+  std::cout << "Compiled list:\n";
+  std::cout << "  Compile time:  " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << " ms\n";
+  std::cout << "  Nodes:         " << list->nodes().size() << "\n";
+  std::cout << "  Edges:         " << list->edges().size() << "\n";
+  std::cout << "  Table size:    "
+            << (list->nodes().size_bytes() + list->edges().size_bytes() + list->labels().size() +
+                list->index().size_bytes())
+            << " bytes\n\n";
+  std::cout << "Performance:\n";
+
+  print_result(run_benchmark("public_suffix", iterations, [&list](auto host) {
+    return list->public_suffix(host).value_or(std::string_view{}).size();
+  }));
+  print_result(run_benchmark("registrable_domain", iterations, [&list](auto host) {
+    return list->registrable_domain(host).value_or(std::string_view{}).size();
+  }));
+  print_result(run_benchmark("is_same_site", iterations, [&list](auto host) {
+    return static_cast<std::size_t>(list->is_same_site(host, "www.example.co.uk"));
+  }));
+
+  std::cout << "\n=================================================\n";
+  return 0;
+}
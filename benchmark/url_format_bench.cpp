@@ -0,0 +1,113 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+
+#include <chrono>
+#include <format>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <skyr/url.hpp>
+#include <skyr/url_format.hpp>
+
+namespace {
+// URLs with and without percent-encoded paths, as they typically appear in logs
+const std::vector<std::string> test_urls = {
+    "http://example.com/path",
+    "https://www.github.com/cpp-netlib/url/blob/main/include/skyr/url.hpp#L123",
+    "https://search.example.com/search?q=test&lang=en&page=1",
+    "http://example.com/path%20with%20spaces",
+    "https://example.org/%E6%96%87%E6%A1%A3/page",
+    "http://test.com/%E2%9C%93/check",
+    "https://api.v2.staging.example.com/v1/users/123/orders?id=123&format=json",
+    "http://192.168.1.1/admin/settings/network",
+    "https://[2001:db8::1]/resource/%CF%80",
+    "file:///C:/Users/test/My%20Documents/document.txt",
+};
+
+struct benchmark_result {
+  std::string_view name;
+  std::size_t urls_processed;
+  long long total_us;
+  double avg_ns_per_url;
+  std::size_t bytes_written;
+};
+
+template <class Format>
+auto run_benchmark(std::string_view name, const std::vector<skyr::url>& urls, std::size_t iterations, Format format)
+    -> benchmark_result {
+  std::size_t bytes = 0;
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for (std::size_t i = 0; i < iterations; ++i) {
+    for (const auto& url : urls) {
+      // Count the output to prevent dead code elimination
+      bytes += format(url);
+    }
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+  auto total_urls = iterations * urls.size();
+  auto avg_ns = (static_cast<double>(duration_us) * 1000.0) / static_cast<double>(total_urls);
+
+  return {name, total_urls, duration_us, avg_ns, bytes};
+}
+
+void print_result(const benchmark_result& result) {
+  std::cout << "  " << std::left << std::setw(32) << result.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << result.avg_ns_per_url << " ns/URL" << std::setprecision(0) << std::setw(14)
+            << (1'000'000'000.0 / result.avg_ns_per_url) << " URLs/second\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t iterations = 100'000;
+
+  if (argc > 1) {
+    try {
+      iterations = std::stoull(argv[1]);
+    } catch (...) {
+      std::cerr << "Usage: " << argv[0] << " [iterations]\n";
+      std::cerr << "  iterations: number of times to format all test URLs (default: 100000)\n";
+      return 1;
+    }
+  }
+
+  auto urls = std::vector<skyr::url>{};
+  for (const auto& url : test_urls) {
+    urls.emplace_back(url);
+  }
+
+  std::cout << "Running URL formatting benchmark...\n";
+  std::cout << "\n=================================================\n";
+  std::cout << "URL Formatting Benchmark Results\n";
+  std::cout << "=================================================\n\n";
+  std::cout << "Configuration:\n";
+  std::cout << "  Test URLs:     " << urls.size() << " unique patterns\n";
+  std::cout << "  Iterations:    " << iterations << "\n\n";
+  std::cout << "Performance:\n";
+
+  print_result(run_benchmark("std::format(\"{}\")", urls, iterations,
+                             [](const skyr::url& url) { return std::format("{}", url).size(); }));
+  print_result(run_benchmark("std::format(\"{:Pd}\")", urls, iterations,
+                             [](const skyr::url& url) { return std::format("{:Pd}", url).size(); }));
+  print_result(run_benchmark("std::format(\"{:>40Pd}\")", urls, iterations,
+                             [](const skyr::url& url) { return std::format("{:>40Pd}", url).size(); }));
+
+  // Appending to a reused buffer, as a logger would, should not allocate at all
+  auto buffer = std::string{};
+  print_result(run_benchmark("std::format_to(buffer, \"{:Pd}\")", urls, iterations, [&buffer](const skyr::url& url) {
+    buffer.clear();
+    std::format_to(std::back_inserter(buffer), "{:Pd}", url);
+    return buffer.size();
+  }));
+
+  std::cout << "\n=================================================\n";
+  return 0;
+}
@@ -38,6 +38,8 @@ enum class url_parse_errc {
   cannot_have_a_username_password_or_port,
   /// Invalid port value
   invalid_port,
+  /// The string is not a serialized origin
+  invalid_origin,
 };
 
 namespace details {
@@ -71,6 +73,8 @@ class url_parse_error_category : public std::error_category {
         return "Cannot have a username, password or port";
       case url_parse_errc::invalid_port:
         return "Invalid port";
+      case url_parse_errc::invalid_origin:
+        return "Invalid origin";
       default:
         return "(Unknown error)";
     }
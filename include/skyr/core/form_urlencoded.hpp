@@ -0,0 +1,237 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_CORE_FORM_URLENCODED_HPP
+#define SKYR_CORE_FORM_URLENCODED_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <skyr/percent_encoding/byte_set.hpp>
+#include <skyr/percent_encoding/percent_decode.hpp>
+#include <skyr/percent_encoding/percent_encoded_char.hpp>
+
+/// \file form_urlencoded.hpp
+/// Provides a push parser and a serializer for
+/// [application/x-www-form-urlencoded](https://url.spec.whatwg.org/#application/x-www-form-urlencoded)
+/// content, e.g. HTML form POST bodies
+
+namespace skyr {
+/// A push parser for application/x-www-form-urlencoded content that is
+/// received in chunks.
+///
+/// Each name-value pair is passed to a callback as soon as it is
+/// complete. `+` is decoded as a space, and percent encoded bytes are
+/// decoded, even when split across chunks. Names and values are collected
+/// in buffers that are reused for every pair and percent decoded in place,
+/// so memory use is bounded by the largest pair and not by the size of the
+/// content. Decoded bytes are not checked to be valid UTF-8.
+///
+/// ```
+/// auto parser = skyr::form_urlencoded_parser();
+/// auto on_pair = [](std::string_view name, std::string_view value) { ... };
+/// parser.feed("name=J+Sm", on_pair);
+/// parser.feed("ith&city=Z%C3%BCrich", on_pair);  // name=J Smith
+/// parser.finish(on_pair);                         // city=Zürich
+/// ```
+class form_urlencoded_parser {
+ public:
+  /// Constructor
+  form_urlencoded_parser() = default;
+
+  /// Parses the next chunk of content
+  ///
+  /// \param chunk The next bytes of the content
+  /// \param callback Called with the decoded name and value of each pair
+  ///        that is completed by this chunk. The arguments are only
+  ///        valid until the callback returns.
+  template <class Callback>
+    requires std::invocable<Callback&, std::string_view, std::string_view>
+  void feed(std::string_view chunk, Callback&& callback) {
+    using namespace std::string_view_literals;
+
+    auto position = std::size_t{0};
+    while (position < chunk.size()) {
+      auto special = chunk.find_first_of(in_value_ ? "&+"sv : "&=+"sv, position);
+      auto run = chunk.substr(position, special - position);
+      if (!run.empty()) {
+        (in_value_ ? value_ : name_).append(run);
+        in_pair_ = true;
+      }
+      if (special == std::string_view::npos) {
+        break;
+      }
+
+      position = special + 1;
+      switch (chunk[special]) {
+        case '&':
+          emit(callback);
+          break;
+        case '=':
+          in_value_ = true;
+          in_pair_ = true;
+          break;
+        default:
+          (in_value_ ? value_ : name_).push_back(' ');
+          in_pair_ = true;
+          break;
+      }
+    }
+  }
+
+  /// Signals the end of the content, and passes the last pair to the
+  /// callback. The parser can then be used for new content.
+  ///
+  /// \param callback Called with the decoded name and value of the last
+  ///        pair, if any
+  template <class Callback>
+    requires std::invocable<Callback&, std::string_view, std::string_view>
+  void finish(Callback&& callback) {
+    emit(callback);
+  }
+
+  /// Discards any partially parsed pair
+  void reset() noexcept {
+    name_.clear();
+    value_.clear();
+    in_value_ = false;
+    in_pair_ = false;
+  }
+
+ private:
+  /// Percent decodes a buffer in place
+  static auto decode(std::string& buffer) -> std::string_view {
+    auto last = percent_encoding::details::percent_decode_lenient_to(buffer.data(), buffer);
+    return std::string_view(buffer.data(), static_cast<std::size_t>(last - buffer.data()));
+  }
+
+  template <class Callback>
+  void emit(Callback& callback) {
+    // Empty sequences, e.g. between "&&", are skipped
+    if (in_pair_) {
+      std::invoke(callback, decode(name_), decode(value_));
+    }
+    name_.clear();
+    value_.clear();
+    in_value_ = false;
+    in_pair_ = false;
+  }
+
+  std::string name_;
+  std::string value_;
+  bool in_value_ = false;
+  bool in_pair_ = false;
+};
+
+/// Parses complete application/x-www-form-urlencoded content
+///
+/// \param content The content
+/// \param callback Called with the decoded name and value of each pair
+template <class Callback>
+  requires std::invocable<Callback&, std::string_view, std::string_view>
+void parse_form_urlencoded(std::string_view content, Callback&& callback) {
+  auto parser = form_urlencoded_parser();
+  parser.feed(content, callback);
+  parser.finish(callback);
+}
+
+/// Encodes a name or value using the application/x-www-form-urlencoded
+/// percent encode set, writing spaces as `+`
+///
+/// \param out An output iterator
+/// \param input The bytes to encode
+/// \returns The output iterator, after the last character written
+template <std::output_iterator<char> OutputIt>
+auto form_urlencode_to(OutputIt out, std::string_view input) -> OutputIt {
+  const auto& bytes = percent_encoding::details::form_urlencoded_bytes;
+
+  auto first = input.data(), last = input.data() + input.size();
+  while (first != last) {
+    // Copy runs of bytes that need no encoding at once
+    auto special = percent_encoding::details::find_first_of(bytes, first, last);
+    out = std::ranges::copy(first, special, out).out;
+    if (special == last) {
+      break;
+    }
+
+    if (*special == ' ') {
+      *out++ = '+';
+    } else {
+      auto byte = std::byte(*special);
+      *out++ = '%';
+      *out++ = percent_encoding::details::hex_to_alnum((byte >> 4) & std::byte(0x0f));
+      *out++ = percent_encoding::details::hex_to_alnum(byte & std::byte(0x0f));
+    }
+    first = std::next(special);
+  }
+  return out;
+}
+
+/// Writes application/x-www-form-urlencoded name-value pairs to an
+/// output iterator as they are appended, so that large content can be
+/// streamed to a sink without building it in memory
+///
+/// ```
+/// auto body = std::string();
+/// auto serializer = skyr::form_urlencoded_serializer(std::back_inserter(body));
+/// serializer.append("name", "J Smith");
+/// serializer.append("city", "Zürich");
+/// assert(body == "name=J+Smith&city=Z%C3%BCrich");
+/// ```
+template <std::output_iterator<char> OutputIt>
+class form_urlencoded_serializer {
+ public:
+  /// \param out The output iterator
+  explicit form_urlencoded_serializer(OutputIt out) : out_(std::move(out)) {
+  }
+
+  /// Encodes and writes a name-value pair
+  ///
+  /// \param name The name
+  /// \param value The value
+  void append(std::string_view name, std::string_view value) {
+    if (!first_) {
+      *out_++ = '&';
+    }
+    first_ = false;
+    out_ = form_urlencode_to(std::move(out_), name);
+    *out_++ = '=';
+    out_ = form_urlencode_to(std::move(out_), value);
+  }
+
+  /// \returns The output iterator, after the last character written
+  [[nodiscard]] auto out() const -> OutputIt {
+    return out_;
+  }
+
+ private:
+  OutputIt out_;
+  bool first_ = true;
+};
+
+/// Serializes name-value pairs as application/x-www-form-urlencoded
+/// content
+///
+/// \param pairs A range of pairs of names and values
+/// \returns The serialized content
+template <std::ranges::input_range Pairs>
+auto serialize_form_urlencoded(Pairs&& pairs) -> std::string {
+  auto result = std::string{};
+  auto serializer = form_urlencoded_serializer(std::back_inserter(result));
+  for (auto&& [name, value] : pairs) {
+    serializer.append(name, value);
+  }
+  return result;
+}
+}  // namespace skyr
+
+#endif  // SKYR_CORE_FORM_URLENCODED_HPP
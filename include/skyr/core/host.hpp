@@ -8,15 +8,20 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <expected>
+#include <functional>
 #include <ranges>
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include <skyr/core/errors.hpp>
 #include <skyr/domain/domain.hpp>
+#include <skyr/domain/domain_cache.hpp>
 #include <skyr/network/ipv4_address.hpp>
 #include <skyr/network/ipv6_address.hpp>
+#include <skyr/percent_encoding/byte_set.hpp>
 #include <skyr/percent_encoding/percent_decode.hpp>
 #include <skyr/percent_encoding/percent_encoded_char.hpp>
 
@@ -24,15 +29,27 @@ namespace skyr {
 /// Represents a domain name in a [URL host](https://url.spec.whatwg.org/#host-representation)
 struct domain_name {
   std::string name;
+
+  friend auto operator==(const domain_name&, const domain_name&) -> bool = default;
 };
 
 /// Represents an opaque host in a [URL host](https://url.spec.whatwg.org/#host-representation)
 struct opaque_host {
   std::string name;
+
+  friend auto operator==(const opaque_host&, const opaque_host&) -> bool = default;
 };
 
 /// Represents an empty host in a [URL host](https://url.spec.whatwg.org/#host-representation)
-struct empty_host {};
+struct empty_host {
+  friend constexpr auto operator==(const empty_host&, const empty_host&) noexcept -> bool = default;
+};
+
+namespace details {
+inline auto hash_combine(std::size_t seed, std::size_t value) noexcept -> std::size_t {
+  return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+}
+}  // namespace details
 
 /// [A URL host](https://url.spec.whatwg.org/#host-representation)
 class host {
@@ -138,6 +155,29 @@ class host {
     return std::holds_alternative<empty_host>(host_);
   }
 
+  /// \returns A hash value that is consistent with `operator==`
+  [[nodiscard]] auto hash() const noexcept -> std::size_t {
+    constexpr static auto hash = [](auto&& host) -> std::size_t {
+      using T = std::decay_t<decltype(host)>;
+
+      if constexpr (std::is_same_v<T, ipv4_address> || std::is_same_v<T, ipv6_address>) {
+        return std::hash<T>{}(host);
+      } else if constexpr (std::is_same_v<T, domain_name> || std::is_same_v<T, opaque_host>) {
+        return std::hash<std::string_view>{}(host.name);
+      } else {
+        return 0;
+      }
+    };
+
+    return details::hash_combine(host_.index(), std::visit(hash, host_));
+  }
+
+  /// Compares two hosts
+  /// \param lhs A host
+  /// \param rhs A host
+  /// \returns `true` if the hosts have the same type and value
+  friend auto operator==(const host& lhs, const host& rhs) -> bool = default;
+
  private:
   host_types host_;
 };
@@ -169,6 +209,47 @@ inline auto parse_opaque_host(std::string_view input, bool* validation_error)
   }
   return opaque_host{std::move(result)};
 }
+
+/// The bytes that a domain can't contain to use `ascii_domain_to_ascii`:
+/// anything other than ASCII letters, digits, `-`, `.` and `_`
+inline constexpr auto non_ldh_bytes = percent_encoding::byte_set::from_predicate([](std::byte byte) {
+  auto value = std::to_integer<unsigned char>(byte);
+  return !(((value >= 'a') && (value <= 'z')) || ((value >= 'A') && (value <= 'Z')) ||
+           ((value >= '0') && (value <= '9')) || (value == '-') || (value == '.') || (value == '_'));
+});
+
+/// Converts a domain that is made of ASCII letters, digits, `-`, `.` and
+/// `_` to ASCII, skipping percent decoding and the UTF-32 IDNA pipeline.
+/// Such a domain is only lowercased by IDNA mapping, and needs no
+/// punycode unless a label starts with `xn--`. Hyphens and label lengths
+/// aren't checked by the non-strict processing that hosts use.
+///
+/// \param input A domain
+/// \param ascii_domain The output, which is allocated once
+/// \returns `false` if the domain needs the full pipeline
+inline auto ascii_domain_to_ascii(std::string_view input, std::string* ascii_domain) -> bool {
+  using namespace std::string_view_literals;
+
+  // Empty labels are left to the full pipeline
+  if (input.empty() || (input.front() == '.') || (input.back() == '.')) {
+    return false;
+  }
+
+  auto first = input.data(), last = input.data() + input.size();
+  if (percent_encoding::details::find_first_of(non_ldh_bytes, first, last) != last) {
+    return false;
+  }
+
+  ascii_domain->resize(input.size());
+  percent_encoding::details::ascii_to_lower(first, last, ascii_domain->data());
+  auto domain = std::string_view(*ascii_domain);
+  if (domain.starts_with("xn--"sv) || (domain.find(".xn--"sv) != std::string_view::npos) ||
+      (domain.find(".."sv) != std::string_view::npos)) {
+    ascii_domain->clear();
+    return false;
+  }
+  return true;
+}
 }  // namespace details
 
 /// Parses a string to either a domain, IPv4 address or IPv6 address according to
@@ -207,24 +288,26 @@ inline auto parse_host(std::string_view input, bool is_not_special, bool* valida
         .and_then([](auto&& h) -> std::expected<host, url_parse_errc> { return host{h}; });
   }
 
-  auto decoded_domain = std::string{};
-  auto range = percent_encoding::percent_decode_range{input};
-  for (auto it = std::cbegin(range); it != std::cend(range); ++it) {
-    if (!*it) {
-      return std::unexpected(url_parse_errc::cannot_decode_host_point);
+  auto ascii_domain = std::string{};
+  if (!details::ascii_domain_to_ascii(input, &ascii_domain)) {
+    auto decoded_domain = std::string{};
+    auto range = percent_encoding::percent_decode_range{input};
+    for (auto it = std::cbegin(range); it != std::cend(range); ++it) {
+      if (!*it) {
+        return std::unexpected(url_parse_errc::cannot_decode_host_point);
+      }
+      decoded_domain.push_back((*it).value());
     }
-    decoded_domain.push_back((*it).value());
-  }
 
-  auto ascii_domain = std::string{};
-  if (!domain_to_ascii(decoded_domain, &ascii_domain)) {
-    return std::unexpected(url_parse_errc::domain_error);
-  }
+    if (!cached_domain_to_ascii(decoded_domain, &ascii_domain)) {
+      return std::unexpected(url_parse_errc::domain_error);
+    }
 
-  auto it = std::ranges::find_if(ascii_domain, details::is_forbidden_host_point);
-  if (std::cend(ascii_domain) != it) {
-    *validation_error |= true;
-    return std::unexpected(url_parse_errc::domain_error);
+    auto it = std::ranges::find_if(ascii_domain, details::is_forbidden_host_point);
+    if (std::cend(ascii_domain) != it) {
+      *validation_error |= true;
+      return std::unexpected(url_parse_errc::domain_error);
+    }
   }
 
   bool ipv4_validation_error = false;
@@ -272,4 +355,15 @@ inline auto parse_host(std::string_view input, bool* validation_error) -> std::e
 }
 }  // namespace skyr
 
+namespace std {
+/// Hashes a skyr::host, so that hosts can be used as keys in unordered
+/// containers
+template <>
+struct hash<skyr::host> {
+  auto operator()(const skyr::host& host) const noexcept -> std::size_t {
+    return host.hash();
+  }
+};
+}  // namespace std
+
 #endif  // SKYR_CORE_HOST_HPP
@@ -6,7 +6,10 @@
 #ifndef SKYR_CORE_PARSE_HPP
 #define SKYR_CORE_PARSE_HPP
 
+#include <algorithm>
 #include <expected>
+#include <iterator>
+#include <memory_resource>
 #include <optional>
 #include <system_error>
 
@@ -17,23 +20,28 @@
 
 namespace skyr {
 namespace details {
-inline auto basic_parse(std::string_view input, bool* validation_error, const url_record* base, const url_record* url,
-                        std::optional<url_parse_state> state_override) -> std::expected<url_record, url_parse_errc> {
+template <class Record>
+inline auto basic_parse(std::string_view input, bool* validation_error, const Record* base, const Record* url,
+                        std::optional<url_parse_state> state_override, const typename Record::allocator_type& alloc)
+    -> std::expected<Record, url_parse_errc> {
   // Remove leading/trailing C0 controls and spaces, and remove all tabs/newlines
   // according to WhatWG spec - this applies to ALL input including setters
-  std::string cleaned_input;
-  std::string_view input_view;
-
   if (!state_override.has_value()) {
     input = remove_leading_c0_control_or_space(input, validation_error);
     input = remove_trailing_c0_control_or_space(input, validation_error);
   }
 
-  // Always remove tabs and newlines from input (even for setters)
-  cleaned_input = remove_tabs_and_newlines(input, validation_error);
-  input_view = cleaned_input;
+  // Always remove tabs and newlines from input (even for setters), but
+  // only copy the input when there is something to remove
+  auto cleaned_input = typename Record::string_type(alloc);
+  if (std::ranges::any_of(input, is_tab_or_newline)) {
+    *validation_error = true;
+    cleaned_input.reserve(input.size());
+    std::ranges::remove_copy_if(input, std::back_inserter(cleaned_input), is_tab_or_newline);
+    input = cleaned_input;
+  }
 
-  auto context = url_parser_context(input_view, validation_error, base, url, state_override);
+  auto context = basic_url_parser_context<Record>(input, validation_error, base, url, state_override, alloc);
   while (true) {
     auto action = context.parse_next();
     if (!action) {
@@ -58,6 +66,11 @@ inline auto basic_parse(std::string_view input, bool* validation_error, const ur
   return std::move(context).get_url();
 }
 
+inline auto basic_parse(std::string_view input, bool* validation_error, const url_record* base, const url_record* url,
+                        std::optional<url_parse_state> state_override) -> std::expected<url_record, url_parse_errc> {
+  return basic_parse(input, validation_error, base, url, state_override, url_record::allocator_type());
+}
+
 inline auto parse(std::string_view input, bool* validation_error, const url_record* base)
     -> std::expected<url_record, url_parse_errc> {
   auto url = basic_parse(input, validation_error, base, nullptr, std::nullopt);
@@ -96,6 +109,40 @@ inline auto parse(std::string_view input, const url_record& base, bool* validati
     -> std::expected<url_record, url_parse_errc> {
   return details::parse(input, validation_error, &base);
 }
+
+namespace pmr {
+/// Parses a URL into a record whose strings, and the parser's own scratch
+/// buffers, are allocated from `resource`
+///
+/// \code
+/// auto buffer = std::array<std::byte, 1024>{};
+/// auto arena = std::pmr::monotonic_buffer_resource(buffer.data(), buffer.size());
+/// auto record = skyr::pmr::parse("https://example.com/path?query", &arena);
+/// \endcode
+///
+/// \param input The input string
+/// \param resource The memory resource
+/// \returns A URL record on success and an error code on failure
+inline auto parse(std::string_view input, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    -> std::expected<url_record, url_parse_errc> {
+  bool validation_error = false;
+  return details::basic_parse<url_record>(input, &validation_error, nullptr, nullptr, std::nullopt,
+                                          url_record::allocator_type(resource));
+}
+
+/// Parses a URL relative to a base record, allocating from `resource`
+/// \param input The input string
+/// \param base A base URL record
+/// \param resource The memory resource
+/// \returns A URL record on success and an error code on failure
+inline auto parse(std::string_view input, const url_record& base,
+                  std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    -> std::expected<url_record, url_parse_errc> {
+  bool validation_error = false;
+  return details::basic_parse<url_record>(input, &validation_error, &base, nullptr, std::nullopt,
+                                          url_record::allocator_type(resource));
+}
+}  // namespace pmr
 }  // namespace skyr
 
 #endif  // SKYR_CORE_PARSE_HPP
@@ -6,11 +6,20 @@
 #ifndef SKYR_CORE_PARSE_QUERY_HPP
 #define SKYR_CORE_PARSE_QUERY_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <optional>
 #include <ranges>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <skyr/core/parse.hpp>
+#include <skyr/core/query_value.hpp>
+#include <skyr/percent_encoding/decoded_view.hpp>
+#include <skyr/percent_encoding/percent_decode.hpp>
 
 namespace skyr {
 ///
@@ -33,53 +42,265 @@ struct query_parameter {
   }
 };
 
+namespace details {
+/// \returns The percent decoded input, or the input if it is not validly
+///          percent encoded. The input is copied once and decoded in
+///          place.
+inline auto decode_or_copy(std::string_view input) -> std::string {
+  auto result = std::string(input);
+  if (!percent_decode_in_place(result)) {
+    result.assign(input);
+  }
+  return result;
+}
+}  // namespace details
+
+/// A query parameter that refers to the characters of a query string
+struct query_parameter_view {
+  /// The raw (percent encoded) name
+  std::string_view name;
+  /// The raw (percent encoded) value, if there is a `=`
+  std::optional<std::string_view> value;
+
+  /// \returns The percent decoded name, or the raw name if it is not
+  ///          validly percent encoded
+  [[nodiscard]] auto decoded_name() const -> std::string {
+    return details::decode_or_copy(name);
+  }
+
+  /// \returns The percent decoded value, or the raw value if it is not
+  ///          validly percent encoded
+  [[nodiscard]] auto decoded_value() const -> std::optional<std::string> {
+    if (!value) {
+      return std::nullopt;
+    }
+    return details::decode_or_copy(value.value());
+  }
+
+  /// \returns A view of the name that is percent decoded as it is
+  ///          iterated or compared
+  [[nodiscard]] constexpr auto decoded_name_view() const noexcept -> percent_encoding::decoded_view {
+    return percent_encoding::decoded_view(name);
+  }
+
+  /// \returns A view of the value that is percent decoded as it is
+  ///          iterated or compared, which is empty if there is no value
+  [[nodiscard]] constexpr auto decoded_value_view() const noexcept -> percent_encoding::decoded_view {
+    return percent_encoding::decoded_view(value.value_or(std::string_view()));
+  }
+
+  /// Converts the value, which is only decoded if it contains a `%`
+  ///
+  /// \tparam T The type of the value
+  /// \returns The converted value, or an error
+  /// \sa parse_query_value
+  template <query_value T>
+  [[nodiscard]] auto value_as() const -> std::expected<T, query_value_errc> {
+    auto raw = value.value_or(std::string_view());
+    if (raw.find('%') == std::string_view::npos) {
+      return parse_query_value<T>(raw);
+    }
+    return parse_query_value<T>(decoded_value().value());
+  }
+};
+
+namespace details {
+/// \param query A query string, without the leading `?`
+/// \returns `true` if the query parser would copy every byte unchanged
+constexpr auto is_encoded_query(std::string_view query) noexcept -> bool {
+  return std::ranges::none_of(query, [](char byte) {
+    return (byte < '!') || (byte > '~') || (byte == '"') || (byte == '#') || (byte == '<') || (byte == '>');
+  });
+}
+
+/// \param raw A raw (percent encoded) name
+/// \param name A decoded name
+/// \returns `true` if the raw name decodes to the name, comparing the
+///          raw name if it is not validly percent encoded
+constexpr auto is_decoded_name(std::string_view raw, std::string_view name) noexcept -> bool {
+  if (raw.find('%') == std::string_view::npos) {
+    return raw == name;
+  }
+
+  auto matches = true;
+  auto it = name.begin();
+  for (auto&& byte : percent_encoding::percent_decode_range{raw}) {
+    if (!byte) {
+      return raw == name;
+    }
+    matches = matches && (it != name.end()) && (*it == byte.value());
+    it = (it != name.end()) ? std::next(it) : it;
+  }
+  return matches && (it == name.end());
+}
+}  // namespace details
+
+/// A lazy view of the parameters of a query string, which are separated
+/// by `&` or `;`. Each parameter refers to the query, and is only
+/// decoded when asked for, so iterating the parameters never allocates.
 ///
-/// \param query
-/// \param validation_error
-/// \return
-inline auto parse_query(std::string_view query, bool* validation_error)
-    -> std::expected<std::vector<query_parameter>, url_parse_errc> {
+/// An empty parameter, e.g. between `&&`, has an empty name and no
+/// value, as it does with `parse_query`.
+///
+/// ```
+/// auto parameters = skyr::query_parameters_view("?a=1&b=x%20y");
+/// assert(parameters.find("b")->decoded_value() == "x y");
+/// ```
+class query_parameters_view : public std::ranges::view_interface<query_parameters_view> {
+ public:
+  /// An iterator through the query parameters
+  class iterator {
+   public:
+    /// \c std::forward_iterator_tag
+    using iterator_category = std::forward_iterator_tag;
+    /// \c query_parameter_view
+    using value_type = query_parameter_view;
+    /// \c std::ptrdiff_t
+    using difference_type = std::ptrdiff_t;
+    /// \c query_parameter_view
+    using reference = query_parameter_view;
+
+    /// Constructs an end iterator
+    constexpr iterator() = default;
+
+    /// \param query The query string, without the leading `?`
+    constexpr explicit iterator(std::string_view query) noexcept : remainder_(query), at_end_(query.empty()) {
+      next();
+    }
+
+    /// \returns The current parameter
+    [[nodiscard]] constexpr auto operator*() const noexcept -> reference {
+      return parameter_;
+    }
+
+    /// Moves to the next parameter
+    constexpr auto operator++() noexcept -> iterator& {
+      next();
+      return *this;
+    }
+
+    /// Moves to the next parameter
+    constexpr auto operator++(int) noexcept -> iterator {
+      auto previous = *this;
+      next();
+      return previous;
+    }
+
+    /// \returns `true` if both iterators are at the same parameter
+    constexpr friend auto operator==(const iterator& lhs, const iterator& rhs) noexcept -> bool {
+      return (lhs.at_end_ && rhs.at_end_) ||
+             ((lhs.at_end_ == rhs.at_end_) && (lhs.parameter_.name.data() == rhs.parameter_.name.data()));
+    }
+
+   private:
+    constexpr void next() noexcept {
+      if (!remainder_) {
+        at_end_ = true;
+        return;
+      }
+
+      auto query = remainder_.value();
+      auto separator = query.find_first_of("&;");
+      auto parameter = query.substr(0, separator);
+      remainder_ = (separator != std::string_view::npos) ? std::optional(query.substr(separator + 1)) : std::nullopt;
+
+      auto delim = parameter.find('=');
+      parameter_.name = parameter.substr(0, delim);
+      parameter_.value = (delim != std::string_view::npos) ? std::optional(parameter.substr(delim + 1)) : std::nullopt;
+    }
+
+    std::optional<std::string_view> remainder_;
+    query_parameter_view parameter_;
+    bool at_end_ = true;
+  };
+
+  /// Constructs an empty view
+  constexpr query_parameters_view() = default;
+
+  /// \param query A percent encoded query string, with or without the
+  ///        leading `?`
+  constexpr explicit query_parameters_view(std::string_view query) noexcept : query_(query) {
+    if (!query_.empty() && (query_.front() == '?')) {
+      query_.remove_prefix(1);
+    }
+  }
+
+  /// \returns An iterator to the first parameter
+  [[nodiscard]] constexpr auto begin() const noexcept {
+    return iterator(query_);
+  }
+
+  /// \returns An iterator past the last parameter
+  [[nodiscard]] constexpr auto end() const noexcept {
+    return iterator();
+  }
+
+  /// \param name A decoded parameter name
+  /// \returns The first parameter whose decoded name is `name`
+  [[nodiscard]] constexpr auto find(std::string_view name) const noexcept -> std::optional<query_parameter_view> {
+    for (auto parameter : *this) {
+      if (details::is_decoded_name(parameter.name, name)) {
+        return parameter;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /// \param name A decoded parameter name
+  /// \returns `true` if there is a parameter whose decoded name is `name`
+  [[nodiscard]] constexpr auto contains(std::string_view name) const noexcept -> bool {
+    return find(name).has_value();
+  }
+
+ private:
+  std::string_view query_;
+};
+
+namespace details {
+/// Percent encodes a query string using the query state of the parser,
+/// and calls a function with a view of its parameters. The parser is
+/// skipped when no byte needs to be encoded.
+template <class Function>
+inline auto visit_query_parameters(std::string_view query, bool* validation_error, Function&& function)
+    -> std::expected<void, url_parse_errc> {
   if (!query.empty() && (query.front() == '?')) {
     query.remove_prefix(1);
   }
 
-  auto url = details::basic_parse(query, validation_error, nullptr, nullptr, url_parse_state::query);
-  if (url) {
-    static constexpr auto is_separator = [](auto c) { return c == '&' || c == ';'; };
+  if (is_encoded_query(query)) {
+    function(query_parameters_view(query));
+    return {};
+  }
 
-    static constexpr auto to_nvp = [](auto&& parameter) -> query_parameter {
-      if (std::ranges::empty(parameter)) {
-        return {};
-      }
+  auto url = details::basic_parse(query, validation_error, nullptr, nullptr, url_parse_state::query);
+  if (!url) {
+    return std::unexpected(url.error());
+  }
+  function(query_parameters_view(url.value().query.value_or(std::string())));
+  return {};
+}
+}  // namespace details
 
-      auto view = std::string_view(std::addressof(*std::begin(parameter)), std::ranges::distance(parameter));
-      auto delim = view.find_first_of('=');
-      if (delim != std::string_view::npos) {
-        return {std::string(view.substr(0, delim)), std::string(view.substr(delim + 1))};
+///
+/// \param query
+/// \param validation_error
+/// \return
+inline auto parse_query(std::string_view query, bool* validation_error)
+    -> std::expected<std::vector<query_parameter>, url_parse_errc> {
+  auto parameters = std::vector<query_parameter>{};
+  auto result = details::visit_query_parameters(query, validation_error, [&parameters](auto view) {
+    for (auto [name, value] : view) {
+      if (value) {
+        parameters.emplace_back(std::string(name), std::string(value.value()));
       } else {
-        return {std::string(view)};
-      }
-    };
-
-    std::vector<query_parameter> parameters{};
-    if (url.value().query) {
-      auto query_str = url.value().query.value();
-      std::size_t start = 0;
-      for (std::size_t i = 0; i <= query_str.size(); ++i) {
-        if (i == query_str.size() || is_separator(query_str[i])) {
-          if (i > start) {
-            auto param_view = query_str.substr(start, i - start);
-            parameters.emplace_back(to_nvp(param_view));
-          } else {
-            parameters.emplace_back();
-          }
-          start = i + 1;
-        }
+        parameters.emplace_back(std::string(name));
       }
     }
-    return parameters;
+  });
+  if (!result) {
+    return std::unexpected(result.error());
   }
-  return std::unexpected(url.error());
+  return parameters;
 }
 
 ///
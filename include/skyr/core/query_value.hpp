@@ -0,0 +1,112 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_CORE_QUERY_VALUE_HPP
+#define SKYR_CORE_QUERY_VALUE_HPP
+
+#include <charconv>
+#include <concepts>
+#include <expected>
+#include <initializer_list>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+/// \file query_value.hpp
+/// Converts decoded query parameter values to integers, floating point
+/// numbers, `bool`s and enums without allocating
+
+namespace skyr {
+/// \enum query_value_errc
+/// Enumerates errors when converting a query parameter value
+enum class query_value_errc {
+  /// There is no parameter with the given name
+  not_found = 1,
+  /// The value is not a valid representation of the type
+  invalid_value,
+  /// The value is out of the range of the type
+  out_of_range,
+};
+
+namespace details {
+/// A type that holds characters rather than numbers
+template <class T>
+concept character_type = std::same_as<T, char> || std::same_as<T, wchar_t> || std::same_as<T, char8_t> ||
+                         std::same_as<T, char16_t> || std::same_as<T, char32_t>;
+
+/// The integer type that the value of an enum with the underlying type
+/// `T` is parsed as, which has the same size and sign as a character type
+template <class T>
+using query_integer_t =
+    std::conditional_t<character_type<T>,
+                       std::conditional_t<std::is_signed_v<T>, std::make_signed_t<T>, std::make_unsigned_t<T>>, T>;
+}  // namespace details
+
+/// A type that a query parameter value can be converted to: `bool`, an
+/// integer that isn't a character type, a floating point number or an
+/// enum
+template <class T>
+concept query_value = std::same_as<T, bool> || (std::integral<T> && !details::character_type<T>) ||
+                      std::floating_point<T> || std::is_enum_v<T>;
+
+/// Converts a decoded query parameter value.
+///
+/// Integers and floating point numbers are parsed with
+/// `std::from_chars`, and must use the whole value. `bool`s are
+/// `true`, `false`, `1` or `0`. Enums are parsed as their underlying
+/// integer value.
+///
+/// \tparam T The type of the value
+/// \param value A decoded value
+/// \returns The converted value, or an error
+template <query_value T>
+constexpr auto parse_query_value(std::string_view value) -> std::expected<T, query_value_errc> {
+  if constexpr (std::same_as<T, bool>) {
+    if ((value == "true") || (value == "1")) {
+      return true;
+    } else if ((value == "false") || (value == "0")) {
+      return false;
+    }
+    return std::unexpected(query_value_errc::invalid_value);
+  } else if constexpr (std::is_enum_v<T>) {
+    auto result = parse_query_value<details::query_integer_t<std::underlying_type_t<T>>>(value);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    return static_cast<T>(result.value());
+  } else {
+    auto result = T{};
+    auto last = value.data() + value.size();
+    auto [ptr, ec] = std::from_chars(value.data(), last, result);
+    if (ec == std::errc::result_out_of_range) {
+      return std::unexpected(query_value_errc::out_of_range);
+    } else if ((ec != std::errc{}) || (ptr != last)) {
+      return std::unexpected(query_value_errc::invalid_value);
+    }
+    return result;
+  }
+}
+
+/// Converts a decoded query parameter value to an enum by name
+///
+/// \tparam T The enum type
+/// \param value A decoded value
+/// \param names The name of each enum value
+/// \returns The enum value with the given name, or an error
+template <class T>
+  requires std::is_enum_v<T>
+constexpr auto parse_query_value(std::string_view value, std::initializer_list<std::pair<std::string_view, T>> names)
+    -> std::expected<T, query_value_errc> {
+  for (const auto& [name, enumerator] : names) {
+    if (name == value) {
+      return enumerator;
+    }
+  }
+  return std::unexpected(query_value_errc::invalid_value);
+}
+}  // namespace skyr
+
+#endif  // SKYR_CORE_QUERY_VALUE_HPP
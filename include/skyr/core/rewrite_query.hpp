@@ -0,0 +1,234 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_CORE_REWRITE_QUERY_HPP
+#define SKYR_CORE_REWRITE_QUERY_HPP
+
+#include <algorithm>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <skyr/percent_encoding/percent_decode.hpp>
+
+/// \file rewrite_query.hpp
+/// Provides functions that rewrite the parameters of a serialized query
+/// string in a single pass, without decoding and re-encoding the
+/// parameters that are kept
+
+namespace skyr {
+/// What to do with a query parameter when rewriting a query
+enum class query_rewrite_action {
+  /// Copy the parameter verbatim
+  keep,
+  /// Remove the parameter
+  drop,
+  /// Keep the name but replace the value
+  replace,
+};
+
+/// The decision made for a single query parameter by the callback
+/// passed to `rewrite_query`
+struct query_rewrite {
+  /// The action to take
+  query_rewrite_action action = query_rewrite_action::keep;
+  /// The replacement value, which is written as is and so must
+  /// already be percent encoded
+  std::string_view value;
+
+  /// \returns A decision to copy the parameter verbatim
+  static constexpr auto keep() noexcept -> query_rewrite {
+    return {query_rewrite_action::keep, {}};
+  }
+
+  /// \returns A decision to remove the parameter
+  static constexpr auto drop() noexcept -> query_rewrite {
+    return {query_rewrite_action::drop, {}};
+  }
+
+  /// \param value The new, percent encoded, value
+  /// \returns A decision to replace the parameter value
+  static constexpr auto replace(std::string_view value) noexcept -> query_rewrite {
+    return {query_rewrite_action::replace, value};
+  }
+};
+
+/// A precompiled set of query parameter names, used to match large
+/// allow or deny lists against query parameters.
+///
+/// A pattern that ends with `*` matches every name that starts with
+/// the rest of the pattern, e.g. `utm_*` matches `utm_source` and
+/// `utm_campaign`. Every other pattern matches one name exactly.
+///
+/// Exact names are sorted once, so that each lookup is a binary search
+/// that is usually rejected by a length or first byte check. Prefixes
+/// that are covered by a shorter prefix are removed, so that at most
+/// one prefix needs to be compared with each name.
+class query_name_set {
+ public:
+  /// Constructs an empty set
+  query_name_set() = default;
+
+  /// Constructs a set from a list of patterns
+  /// \param patterns Parameter names, or prefixes ending with `*`
+  query_name_set(std::initializer_list<std::string_view> patterns)
+      : query_name_set(std::span<const std::string_view>(patterns.begin(), patterns.size())) {
+  }
+
+  /// Constructs a set from a range of patterns
+  /// \param patterns Parameter names, or prefixes ending with `*`
+  template <std::ranges::input_range Patterns>
+    requires std::convertible_to<std::ranges::range_reference_t<Patterns>, std::string_view>
+  explicit query_name_set(Patterns&& patterns) {
+    for (auto&& pattern : patterns) {
+      auto view = std::string_view(pattern);
+      if (view.ends_with('*')) {
+        view.remove_suffix(1);
+        prefixes_.emplace_back(view);
+      } else {
+        names_.emplace_back(view);
+        min_size_ = std::min(min_size_, view.size());
+        max_size_ = std::max(max_size_, view.size());
+      }
+      if (!view.empty()) {
+        first_bytes_.set(static_cast<unsigned char>(view.front()));
+      }
+    }
+
+    std::ranges::sort(names_);
+    auto duplicates = std::ranges::unique(names_);
+    names_.erase(duplicates.begin(), duplicates.end());
+
+    std::ranges::sort(prefixes_);
+    auto covered = std::ranges::unique(prefixes_, [](std::string_view lhs, std::string_view rhs) {
+      return rhs.starts_with(lhs);
+    });
+    prefixes_.erase(covered.begin(), covered.end());
+  }
+
+  /// \returns `true` if the set contains no patterns
+  [[nodiscard]] auto empty() const noexcept -> bool {
+    return names_.empty() && prefixes_.empty();
+  }
+
+  /// \param name A decoded query parameter name
+  /// \returns `true` if the name matches one of the patterns
+  [[nodiscard]] auto contains(std::string_view name) const noexcept -> bool {
+    if (!name.empty() && !first_bytes_.test(static_cast<unsigned char>(name.front()))) {
+      return !prefixes_.empty() && prefixes_.front().empty();
+    }
+
+    if ((name.size() >= min_size_) && (name.size() <= max_size_) &&
+        std::ranges::binary_search(names_, name, std::less<>{})) {
+      return true;
+    }
+
+    // Only the greatest prefix that is not greater than the name can match
+    auto it = std::ranges::upper_bound(prefixes_, name, std::less<>{});
+    return (it != prefixes_.begin()) && name.starts_with(*std::prev(it));
+  }
+
+ private:
+  std::vector<std::string> names_;
+  std::vector<std::string> prefixes_;
+  std::bitset<std::numeric_limits<unsigned char>::max() + 1> first_bytes_;
+  std::size_t min_size_ = std::numeric_limits<std::size_t>::max();
+  std::size_t max_size_ = 0;
+};
+
+namespace details {
+/// \param name A raw query parameter name
+/// \param names A set of decoded names
+/// \returns `true` if the decoded name is in the set
+inline auto contains_decoded_name(const query_name_set& names, std::string_view name) -> bool {
+  if (name.find('%') != std::string_view::npos) {
+    auto decoded = percent_decode(name);
+    return decoded ? names.contains(decoded.value()) : names.contains(name);
+  }
+  return names.contains(name);
+}
+}  // namespace details
+
+/// Writes the parameters of a serialized query, applying a rewrite
+/// to each one. Parameters are separated by `&`, and empty
+/// parameters are removed.
+///
+/// \param out An output iterator
+/// \param query A serialized query, without the leading `?`
+/// \param rewrite A callback that is passed the raw (percent encoded)
+///        name and value of each parameter and returns a `query_rewrite`
+/// \param prefix Characters written before the first parameter, only if
+///        any parameter is written
+/// \returns The output iterator, after the last character written
+template <std::output_iterator<char> OutputIt, class Rewrite>
+  requires std::is_invocable_r_v<query_rewrite, Rewrite&, std::string_view, std::string_view>
+auto rewrite_query_to(OutputIt out, std::string_view query, Rewrite&& rewrite, std::string_view prefix = {})
+    -> OutputIt {
+  auto separator = prefix;
+  while (!query.empty()) {
+    auto parameter = query.substr(0, query.find('&'));
+    query.remove_prefix(std::min(parameter.size() + 1, query.size()));
+    if (parameter.empty()) {
+      continue;
+    }
+
+    auto delim = parameter.find('=');
+    auto name = parameter.substr(0, delim);
+    auto value = (delim != std::string_view::npos) ? parameter.substr(delim + 1) : std::string_view{};
+    auto decision = std::invoke(rewrite, name, value);
+    if (decision.action == query_rewrite_action::drop) {
+      continue;
+    }
+
+    out = std::ranges::copy(std::exchange(separator, std::string_view("&")), out).out;
+    if (decision.action == query_rewrite_action::replace) {
+      out = std::ranges::copy(name, out).out;
+      *out++ = '=';
+      out = std::ranges::copy(decision.value, out).out;
+    } else {
+      out = std::ranges::copy(parameter, out).out;
+    }
+  }
+  return out;
+}
+
+/// Rewrites the parameters of a serialized query into a new string
+///
+/// \param query A serialized query, without the leading `?`
+/// \param rewrite A callback that is passed the raw (percent encoded)
+///        name and value of each parameter and returns a `query_rewrite`
+/// \returns The rewritten query
+template <class Rewrite>
+  requires std::is_invocable_r_v<query_rewrite, Rewrite&, std::string_view, std::string_view>
+auto rewrite_query(std::string_view query, Rewrite&& rewrite) -> std::string {
+  auto result = std::string{};
+  result.reserve(query.size());
+  rewrite_query_to(std::back_inserter(result), query, rewrite);
+  return result;
+}
+
+/// Removes the parameters whose decoded names are in a set
+///
+/// \param query A serialized query, without the leading `?`
+/// \param names The names of the parameters to remove
+/// \returns The rewritten query
+inline auto rewrite_query(std::string_view query, const query_name_set& names) -> std::string {
+  return rewrite_query(query, [&names](std::string_view name, std::string_view) {
+    return details::contains_decoded_name(names, name) ? query_rewrite::drop() : query_rewrite::keep();
+  });
+}
+}  // namespace skyr
+
+#endif  // SKYR_CORE_REWRITE_QUERY_HPP
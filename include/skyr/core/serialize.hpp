@@ -6,6 +6,8 @@
 #ifndef SKYR_CORE_SERIALIZE_HPP
 #define SKYR_CORE_SERIALIZE_HPP
 
+#include <array>
+#include <charconv>
 #include <format>
 #include <ranges>
 
@@ -51,8 +53,18 @@ inline auto serialize_path(const std::vector<std::string>& path) -> std::string
   return result;
 }
 
+/// Without a host, a path whose first segment is empty is prefixed with "/." so that it isn't read back as an
+/// authority
+template <class Allocator>
+inline auto has_path_dot_prefix(const basic_url_record<Allocator>& url) -> bool {
+  return !url.host && !url.cannot_be_a_base_url && (url.path.size() > 1) && url.path.front().empty();
+}
+
 inline auto serialize_path(const url_record& url) -> std::string {
-  return url.cannot_be_a_base_url ? url.path.front() : serialize_path(url.path);
+  if (url.cannot_be_a_base_url) {
+    return url.path.front();
+  }
+  return has_path_dot_prefix(url) ? std::format("/.{}", serialize_path(url.path)) : serialize_path(url.path);
 }
 
 inline auto serialize_query(const url_record& url) -> std::string {
@@ -82,6 +94,83 @@ inline auto serialize_excluding_fragment(const url_record& url) -> url_record::s
 inline auto serialize(const url_record& url) -> url_record::string_type {
   return std::format("{}{}", serialize_excluding_fragment(url), details::serialize_fragment(url));
 }
+
+namespace pmr {
+/// Serializes a URL record according to the
+/// [WhatWG specification](https://url.spec.whatwg.org/#url-serializing),
+/// allocating the result from the record's memory resource
+///
+/// \param url A URL record
+/// \returns A serialized URL string
+inline auto serialize(const url_record& url) -> url_record::string_type {
+  auto host = url.host ? url.host.value().serialize() : std::string();
+  auto port = std::array<char, 5>{};
+  auto port_size = std::size_t{0};
+  if (url.port) {
+    auto [last, ec] = std::to_chars(port.data(), port.data() + port.size(), url.port.value());
+    port_size = static_cast<std::size_t>(last - port.data());
+  }
+
+  auto size = url.scheme.size() + 1;
+  if (url.host) {
+    size += 2 + host.size() + (port_size ? port_size + 1 : 0);
+    if (url.includes_credentials()) {
+      size += url.username.size() + (url.password.empty() ? 0 : url.password.size() + 1) + 1;
+    }
+  } else if (url.scheme == "file") {
+    size += 2;
+  }
+  size += details::has_path_dot_prefix(url) ? 2 : 0;
+  for (const auto& segment : url.path) {
+    size += segment.size() + (url.cannot_be_a_base_url ? 0 : 1);
+  }
+  size += url.query ? url.query.value().size() + 1 : 0;
+  size += url.fragment ? url.fragment.value().size() + 1 : 0;
+
+  auto result = url_record::string_type(url.get_allocator());
+  result.reserve(size);
+  result.append(url.scheme);
+  result.push_back(':');
+  if (url.host) {
+    result.append("//");
+    if (url.includes_credentials()) {
+      result.append(url.username);
+      if (!url.password.empty()) {
+        result.push_back(':');
+        result.append(url.password);
+      }
+      result.push_back('@');
+    }
+    result.append(host);
+    if (port_size) {
+      result.push_back(':');
+      result.append(port.data(), port_size);
+    }
+  } else if (url.scheme == "file") {
+    result.append("//");
+  }
+  if (details::has_path_dot_prefix(url)) {
+    result.append("/.");
+  }
+  if (url.cannot_be_a_base_url) {
+    result.append(url.path.front());
+  } else {
+    for (const auto& segment : url.path) {
+      result.push_back('/');
+      result.append(segment);
+    }
+  }
+  if (url.query) {
+    result.push_back('?');
+    result.append(url.query.value());
+  }
+  if (url.fragment) {
+    result.push_back('#');
+    result.append(url.fragment.value());
+  }
+  return result;
+}
+}  // namespace pmr
 }  // namespace skyr
 
 #endif  // SKYR_CORE_SERIALIZE_HPP
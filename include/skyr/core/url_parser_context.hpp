@@ -84,7 +84,8 @@ constexpr inline auto is_double_dot_path_segment(std::string_view segment) noexc
          (segment == "%2e%2E");
 }
 
-inline void shorten_path(std::string_view scheme, std::vector<std::string>& path) {
+template <class Path>
+inline void shorten_path(std::string_view scheme, Path& path) {
   if (!path.empty() && !((scheme == "file"sv) && (path.size() == 1) && is_windows_drive_letter(path.front()))) {
     path.pop_back();
   }
@@ -97,36 +98,38 @@ enum class url_parse_action {
   continue_,
 };
 
-class url_parser_context {
+template <class Record>
+class basic_url_parser_context {
  private:
-  url_record url;
+  Record url;
   url_parse_state state;
   std::string_view input;
   std::string_view::const_iterator input_it;
   bool* validation_error;
-  const url_record* base;
+  const Record* base;
   std::optional<url_parse_state> state_override;
-  std::string buffer;
+  typename Record::string_type buffer;
 
   bool at_flag;
   bool square_braces_flag;
 
  public:
-  url_parser_context(std::string_view input, bool* validation_error, const url_record* base, const url_record* url,
-                     std::optional<url_parse_state> state_override)
-      : url(url ? *url : url_record{})
+  basic_url_parser_context(std::string_view input, bool* validation_error, const Record* base, const Record* url,
+                           std::optional<url_parse_state> state_override,
+                           const typename Record::allocator_type& alloc = {})
+      : url(url ? Record(*url, alloc) : Record(alloc))
       , state(state_override ? state_override.value() : url_parse_state::scheme_start)
       , input(input)
       , input_it(begin(input))
       , validation_error(validation_error)
       , base(base)
       , state_override(state_override)
-      , buffer()
+      , buffer(alloc)
       , at_flag(false)
       , square_braces_flag(false) {
   }
 
-  [[nodiscard]] auto get_url() && -> url_record&& {
+  [[nodiscard]] auto get_url() && -> Record&& {
     return std::move(url);
   }
 
@@ -909,11 +912,14 @@ class url_parser_context {
   }
 
   void set_empty_query() {
-    url.query = std::string();
+    url.query.emplace(url.get_allocator());
   }
 
   void set_query_from_base() {
-    url.query = base->query;
+    url.query.reset();
+    if (base->query) {
+      url.query.emplace(base->query.value(), url.get_allocator());
+    }
   }
 
   void pct_encode_and_append_to_query(char byte) {
@@ -932,7 +938,7 @@ class url_parser_context {
   }
 
   void set_empty_fragment() {
-    url.fragment = std::string();
+    url.fragment.emplace(url.get_allocator());
   }
 
   void append_to_fragment(char byte) {
@@ -943,6 +949,8 @@ class url_parser_context {
     url.fragment.value() += pct_encoded.to_string();
   }
 };
+
+using url_parser_context = basic_url_parser_context<url_record>;
 }  // namespace skyr
 
 #endif  // SKYR_CORE_URL_PARSER_CONTEXT_HPP
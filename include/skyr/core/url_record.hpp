@@ -6,9 +6,14 @@
 #ifndef SKYR_CORE_URL_RECORD_HPP
 #define SKYR_CORE_URL_RECORD_HPP
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <skyr/core/host.hpp>
@@ -16,11 +21,17 @@
 
 namespace skyr {
 /// Represents the parts of a URL identifier.
-class url_record {
+///
+/// \tparam Allocator The allocator used by every string in the record
+template <class Allocator>
+class basic_url_record {
  public:
+  /// allocator type
+  using allocator_type = Allocator;
+
   /// string type
   /// \sa url::string_type
-  using string_type = std::string;
+  using string_type = std::basic_string<char, std::char_traits<char>, Allocator>;
 
   /// An ASCII string that identifies the type of URL
   string_type scheme;
@@ -35,7 +46,7 @@ class url_record {
   std::optional<std::uint16_t> port;
   /// A list of zero or more ASCII strings, used to identify a
   /// location in a hierarchical form
-  std::vector<string_type> path;
+  std::vector<string_type, typename std::allocator_traits<Allocator>::template rebind_alloc<string_type>> path;
   /// An optional ASCII string
   std::optional<string_type> query;
   /// An optional ASCII string
@@ -46,7 +57,48 @@ class url_record {
   bool cannot_be_a_base_url = false;
 
   /// Default constructor
-  url_record() = default;
+  basic_url_record() = default;
+
+  /// Constructs an empty record that allocates from `alloc`
+  /// \param alloc An allocator
+  explicit basic_url_record(const allocator_type& alloc) noexcept
+      : scheme(alloc), username(alloc), password(alloc), path(alloc) {
+  }
+
+  /// Copy constructor
+  basic_url_record(const basic_url_record&) = default;
+
+  /// Move constructor
+  basic_url_record(basic_url_record&&) noexcept = default;
+
+  /// Copies a record into storage allocated from `alloc`
+  /// \param other Another record
+  /// \param alloc An allocator
+  basic_url_record(const basic_url_record& other, const allocator_type& alloc)
+      : scheme(other.scheme, alloc)
+      , username(other.username, alloc)
+      , password(other.password, alloc)
+      , host(other.host)
+      , port(other.port)
+      , path(other.path, alloc)
+      , query(copy_optional(other.query, alloc))
+      , fragment(copy_optional(other.fragment, alloc))
+      , cannot_be_a_base_url(other.cannot_be_a_base_url) {
+  }
+
+  /// Copy assignment operator
+  auto operator=(const basic_url_record&) -> basic_url_record& = default;
+
+  /// Move assignment operator
+  auto operator=(basic_url_record&&) noexcept -> basic_url_record& = default;
+
+  /// Destructor
+  ~basic_url_record() = default;
+
+  /// \returns The allocator used by the record
+  [[nodiscard]] auto get_allocator() const noexcept -> allocator_type {
+    return scheme.get_allocator();
+  }
 
   /// Tests if the URL is a special scheme
   /// \returns `true` if the URL scheme is a special scheme, `false`
@@ -71,7 +123,7 @@ class url_record {
 
   /// Swaps two `url_record` objects
   /// \param other Another `url_record` object
-  void swap(url_record& other) noexcept {
+  void swap(basic_url_record& other) noexcept {
     using std::swap;
     swap(scheme, other.scheme);
     swap(username, other.username);
@@ -83,17 +135,73 @@ class url_record {
     swap(fragment, other.fragment);
     swap(cannot_be_a_base_url, other.cannot_be_a_base_url);
   }
+
+ private:
+  static auto copy_optional(const std::optional<string_type>& value, const allocator_type& alloc)
+      -> std::optional<string_type> {
+    return value ? std::optional<string_type>(std::in_place, value.value(), alloc) : std::nullopt;
+  }
 };
 
+/// A URL record that uses the default allocator
+using url_record = basic_url_record<std::allocator<char>>;
+
+namespace pmr {
+/// A URL record whose strings are allocated from a `std::pmr::memory_resource`
+using url_record = basic_url_record<std::pmr::polymorphic_allocator<char>>;
+}  // namespace pmr
+
 /// Swaps two `url_record` objects
 ///
 /// Equivalent to `lhs.swap(rhs)`
 ///
 /// \param lhs A `url_record` object
 /// \param rhs A `url_record` object
-inline void swap(url_record& lhs, url_record& rhs) noexcept {
+template <class Allocator>
+inline void swap(basic_url_record<Allocator>& lhs, basic_url_record<Allocator>& rhs) noexcept {
   lhs.swap(rhs);
 }
+
+/// Compares two URL records component by component
+///
+/// \param lhs A `url_record` object
+/// \param rhs A `url_record` object
+/// \returns `true` if every component is equal
+template <class Allocator>
+inline auto operator==(const basic_url_record<Allocator>& lhs, const basic_url_record<Allocator>& rhs) -> bool {
+  return (lhs.scheme == rhs.scheme) && (lhs.username == rhs.username) && (lhs.password == rhs.password) &&
+         (lhs.host == rhs.host) && (lhs.port == rhs.port) && (lhs.path == rhs.path) && (lhs.query == rhs.query) &&
+         (lhs.fragment == rhs.fragment) && (lhs.cannot_be_a_base_url == rhs.cannot_be_a_base_url);
+}
 }  // namespace skyr
 
+namespace std {
+/// Hashes a skyr::basic_url_record from its components, without
+/// serializing it
+template <class Allocator>
+struct hash<skyr::basic_url_record<Allocator>> {
+  auto operator()(const skyr::basic_url_record<Allocator>& record) const noexcept -> std::size_t {
+    using skyr::details::hash_combine;
+
+    constexpr auto hash_string = [](std::string_view value) { return std::hash<std::string_view>{}(value); };
+    constexpr auto hash_optional = [](const auto& value) {
+      return value ? std::hash<std::string_view>{}(value.value()) : std::size_t(0x9e3779b97f4a7c15ULL);
+    };
+
+    auto seed = hash_string(record.scheme);
+    seed = hash_combine(seed, hash_string(record.username));
+    seed = hash_combine(seed, hash_string(record.password));
+    seed = hash_combine(seed, record.host ? record.host.value().hash() : 0);
+    seed = hash_combine(seed, record.port ? record.port.value() : 0x10000u);
+    seed = hash_combine(seed, record.path.size());
+    for (const auto& segment : record.path) {
+      seed = hash_combine(seed, hash_string(segment));
+    }
+    seed = hash_combine(seed, hash_optional(record.query));
+    seed = hash_combine(seed, hash_optional(record.fragment));
+    return hash_combine(seed, record.cannot_be_a_base_url ? 1 : 0);
+  }
+};
+}  // namespace std
+
 #endif  // SKYR_CORE_URL_RECORD_HPP
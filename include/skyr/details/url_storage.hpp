@@ -0,0 +1,203 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_DETAILS_URL_STORAGE_HPP
+#define SKYR_DETAILS_URL_STORAGE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <skyr/core/serialize.hpp>
+#include <skyr/core/url_record.hpp>
+#include <skyr/url_search_parameters.hpp>
+
+namespace skyr::details {
+/// The boundaries of each component in a serialized URL record
+struct url_component_offsets {
+  std::size_t protocol_end = 0;
+  std::size_t username_begin = 0;
+  std::size_t username_end = 0;
+  std::size_t password_begin = 0;
+  std::size_t password_end = 0;
+  std::size_t hostname_begin = 0;
+  std::size_t hostname_end = 0;
+  std::size_t port_begin = 0;
+  std::size_t port_end = 0;
+  std::size_t pathname_begin = 0;
+  std::size_t search_begin = 0;
+  std::size_t hash_begin = 0;
+};
+
+/// Computes the component boundaries of `href`, which must be the
+/// serialization of `record`
+///
+/// \param record A URL record
+/// \param href The serialized URL record
+/// \returns The component boundaries
+inline auto make_component_offsets(const url_record& record, std::string_view href) noexcept
+    -> url_component_offsets {
+  constexpr auto count_digits = [](std::uint16_t value) -> std::size_t {
+    auto digits = std::size_t{1};
+    while (value >= 10) {
+      value /= 10;
+      ++digits;
+    }
+    return digits;
+  };
+
+  auto offsets = url_component_offsets{};
+
+  // Leading components are measured from the start of the string...
+  auto position = record.scheme.size() + 1;
+  offsets.protocol_end = position;
+  if (record.host || (record.scheme == "file")) {
+    position += 2;
+  } else if (has_path_dot_prefix(record)) {
+    // The "/." before the path is part of neither the host nor the path
+    position += 2;
+  }
+
+  offsets.username_begin = position;
+  offsets.username_end = position;
+  offsets.password_begin = position;
+  offsets.password_end = position;
+  if (record.host && record.includes_credentials()) {
+    position += record.username.size();
+    offsets.username_end = position;
+    if (!record.password.empty()) {
+      offsets.password_begin = position + 1;
+      position += record.password.size() + 1;
+      offsets.password_end = position;
+    } else {
+      offsets.password_begin = position;
+      offsets.password_end = position;
+    }
+    ++position;
+  }
+  offsets.hostname_begin = position;
+
+  // ...and trailing components from the end, so that the host is
+  // never serialized a second time
+  auto end = href.size();
+  offsets.hash_begin = record.fragment ? end - record.fragment.value().size() - 1 : end;
+  offsets.search_begin = record.query ? offsets.hash_begin - record.query.value().size() - 1 : offsets.hash_begin;
+
+  auto path_size = std::size_t{0};
+  if (record.cannot_be_a_base_url) {
+    path_size = record.path.front().size();
+  } else {
+    for (const auto& segment : record.path) {
+      path_size += segment.size() + 1;
+    }
+  }
+  offsets.pathname_begin = offsets.search_begin - path_size;
+
+  offsets.port_end = offsets.pathname_begin;
+  offsets.port_begin = record.port ? offsets.port_end - count_digits(record.port.value()) : offsets.port_end;
+  offsets.hostname_end = record.port ? offsets.port_begin - 1 : offsets.port_begin;
+  return offsets;
+}
+
+/// The state of a `url` object. Copies of a `url` share one
+/// `url_storage` through an atomic reference count, and it is
+/// treated as immutable while it is shared.
+struct url_storage {
+  url_storage() = default;
+
+  /// Copies the state of another `url_storage`, which is referenced
+  /// once
+  url_storage(const url_storage& other)
+      : record(other.record),
+        href(other.href),
+        offsets(other.offsets),
+        parameters(other.parameters),
+        is_shareable(other.is_shareable) {
+  }
+
+  url_storage& operator=(const url_storage&) = delete;
+
+  /// The URL record
+  url_record record;
+  /// The serialized URL record
+  std::string href;
+  /// The boundaries of each component in `href`
+  url_component_offsets offsets;
+  /// The parsed query
+  url_search_parameters parameters;
+  /// `false` once a mutable reference to `parameters` has escaped
+  bool is_shareable = true;
+  /// The number of `url_storage_ptr` objects that refer to this storage
+  std::atomic<std::size_t> references = 1;
+};
+
+/// An intrusive reference counted pointer to a `url_storage`.
+///
+/// Unlike `std::shared_ptr::use_count`, `is_unique` reads the
+/// reference count with acquire ordering, so that when it returns
+/// `true`, everything other threads did with the storage before
+/// releasing their references happens before it is modified.
+class url_storage_ptr {
+ public:
+  /// Constructs a pointer that doesn't refer to any storage
+  url_storage_ptr() noexcept : storage_(nullptr) {
+  }
+
+  /// Takes ownership of a storage, which is referenced once
+  explicit url_storage_ptr(url_storage* storage) noexcept : storage_(storage) {
+  }
+
+  url_storage_ptr(const url_storage_ptr& other) noexcept : storage_(other.storage_) {
+    if (storage_ != nullptr) {
+      storage_->references.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  url_storage_ptr(url_storage_ptr&& other) noexcept : storage_(std::exchange(other.storage_, nullptr)) {
+  }
+
+  url_storage_ptr& operator=(url_storage_ptr other) noexcept {
+    std::swap(storage_, other.storage_);
+    return *this;
+  }
+
+  ~url_storage_ptr() {
+    if ((storage_ != nullptr) && (storage_->references.fetch_sub(1, std::memory_order_acq_rel) == 1)) {
+      delete storage_;
+    }
+  }
+
+  /// \returns `true` if no other `url_storage_ptr` refers to the storage
+  [[nodiscard]] auto is_unique() const noexcept -> bool {
+    return storage_->references.load(std::memory_order_acquire) == 1;
+  }
+
+  [[nodiscard]] auto operator->() const noexcept -> url_storage* {
+    return storage_;
+  }
+
+  [[nodiscard]] auto operator*() const noexcept -> url_storage& {
+    return *storage_;
+  }
+
+  friend void swap(url_storage_ptr& lhs, url_storage_ptr& rhs) noexcept {
+    std::swap(lhs.storage_, rhs.storage_);
+  }
+
+ private:
+  url_storage* storage_;
+};
+
+/// \returns The storage shared by all empty `url` objects
+inline auto empty_url_storage() -> const url_storage_ptr& {
+  static const auto storage = url_storage_ptr(new url_storage());
+  return storage;
+}
+}  // namespace skyr::details
+
+#endif  // SKYR_DETAILS_URL_STORAGE_HPP
@@ -6,6 +6,7 @@
 #define SKYR_URL_DOMAIN_HPP
 
 #include <skyr/domain/domain.hpp>
+#include <skyr/domain/domain_cache.hpp>
 #include <skyr/domain/errors.hpp>
 #include <skyr/domain/idna.hpp>
 #include <skyr/domain/idna_status.hpp>
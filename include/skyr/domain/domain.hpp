@@ -7,8 +7,11 @@
 #define SKYR_DOMAIN_DOMAIN_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <expected>
 #include <iterator>
+#include <memory_resource>
 #include <ranges>
 #include <string>
 #include <string_view>
@@ -63,25 +66,16 @@ constexpr inline auto validate_label(std::u32string_view label, [[maybe_unused]]
   return {};
 }
 
-///
-struct domain_to_ascii_context {
-  /// Stores the domain as UTF-32
-  std::u32string domain_name;
-
-  /// Parameters
-  std::string* ascii_domain;
-  bool check_hyphens;
-  bool check_bidi;
-  bool check_joiners;
-  bool use_std3_ascii_rules;
-  bool transitional_processing;
-  bool verify_dns_length;
-
-  // These are intermediate buffers
-  std::vector<std::u32string> labels;
-  std::string punycode_encoded;
-  std::u32string punycode_decoded;
-};
+namespace details {
+/// The size of the stack buffer used to convert a domain. It fits every
+/// valid DNS name, and only longer input falls back to the heap.
+inline constexpr auto domain_buffer_size = std::size_t{4096};
+
+/// \returns `true` if the label can be written without Punycode encoding
+constexpr auto is_ascii_label(std::u32string_view label) noexcept {
+  return std::ranges::all_of(label, [](auto c) { return c <= U'\x7e'; });
+}
+}  // namespace details
 
 ///
 /// \param domain_name
@@ -93,152 +87,101 @@ struct domain_to_ascii_context {
 /// \param transitional_processing
 /// \param verify_dns_length
 /// \return
-inline auto create_domain_to_ascii_context(std::string_view domain_name, std::string* ascii_domain, bool check_hyphens,
-                                           bool check_bidi, bool check_joiners, bool use_std3_ascii_rules,
-                                           bool transitional_processing, bool verify_dns_length)
-    -> std::expected<domain_to_ascii_context, domain_errc> {
-  auto u32domain_name = unicode::as<std::u32string>(unicode::views::as_u8(domain_name) | unicode::transforms::to_u32);
-  if (u32domain_name) {
-    return domain_to_ascii_context{u32domain_name.value(),
-                                   ascii_domain,
-                                   check_hyphens,
-                                   check_bidi,
-                                   check_joiners,
-                                   use_std3_ascii_rules,
-                                   transitional_processing,
-                                   verify_dns_length,
-                                   {},
-                                   {},
-                                   {}};
-  } else {
-    return std::unexpected(domain_errc::encoding_error);
-  }
-}
-
-///
-/// \param context
-/// \return
-inline auto domain_to_ascii_impl(domain_to_ascii_context&& context) -> std::expected<void, domain_errc> {
+inline auto domain_to_ascii(std::string_view domain_name, std::string* ascii_domain, bool check_hyphens,
+                            bool check_bidi, bool check_joiners, bool use_std3_ascii_rules,
+                            bool transitional_processing, bool verify_dns_length) -> std::expected<void, domain_errc> {
   /// https://www.unicode.org/reports/tr46/#ToASCII
-
-  constexpr auto map_domain_name =
-      [](domain_to_ascii_context&& ctx) -> std::expected<domain_to_ascii_context, domain_errc> {
-    auto result = idna::map_code_points(ctx.domain_name, ctx.use_std3_ascii_rules, ctx.transitional_processing);
-    if (result) {
-      ctx.domain_name.erase(result.value(), std::cend(ctx.domain_name));
-      return std::move(ctx);
-    } else {
-      return std::unexpected(result.error());
+  using namespace std::string_view_literals;
+
+  constexpr auto max_domain_length = 253;
+  constexpr auto max_label_length = 63;
+
+  // The intermediate strings are allocated from a buffer on the stack, so
+  // that only the output is allocated on the heap
+  std::array<std::byte, details::domain_buffer_size> buffer;
+  auto resource = std::pmr::monotonic_buffer_resource(buffer.data(), buffer.size(), std::pmr::new_delete_resource());
+
+  auto code_points = std::pmr::u32string(&resource);
+  code_points.reserve(domain_name.size());
+  for (auto&& code_point : unicode::views::as_u8(domain_name)) {
+    auto value = unicode::u32_value(code_point);
+    if (!value) {
+      return std::unexpected(domain_errc::encoding_error);
     }
-  };
+    code_points.push_back(value.value());
+  }
 
-  constexpr auto process_labels = [](auto&& ctx) -> std::expected<std::decay_t<decltype(ctx)>, domain_errc> {
-    using namespace std::string_view_literals;
+  // The whole domain is mapped before it is split, because mapping can
+  // produce label separators, e.g. U+3002 IDEOGRAPHIC FULL STOP. A code
+  // point can map to more than one, e.g. U+0133 maps to "ij"
+  auto mapped = std::pmr::u32string(&resource);
+  mapped.reserve(code_points.size());
+  auto mapped_last =
+      idna::map_code_points(code_points, std::back_inserter(mapped), use_std3_ascii_rules, transitional_processing);
+  if (!mapped_last) {
+    return std::unexpected(mapped_last.error());
+  }
 
-    constexpr auto to_string_view = [](auto&& label) {
-      auto size = std::ranges::distance(label);
-      return std::u32string_view(std::addressof(*std::cbegin(label)), size);
-    };
+  auto encoded = std::pmr::string(&resource);
+  encoded.reserve(domain_name.size() + 16);
+  auto decoded = std::pmr::u32string(&resource);
+  auto invalid_length = false;
 
-    for (auto&& label :
-         ctx.domain_name | std::ranges::views::split(U'.') | std::ranges::views::transform(to_string_view)) {
-      if ((label.size() >= 4) && (label.substr(0, 4) == U"xn--")) {
-        ctx.punycode_decoded.clear();
-        auto decoded = punycode_decode(label.substr(4), &ctx.punycode_decoded);
-        if (!decoded) {
-          return std::unexpected(decoded.error());
+  auto remaining = std::u32string_view(mapped);
+  while (true) {
+    auto separator = remaining.find(U'.');
+    auto label = remaining.substr(0, separator);
+
+    if (!label.empty()) {
+      if (label.starts_with(U"xn--"sv)) {
+        decoded.clear();
+        auto result = punycode_decode(label.substr(4), &decoded);
+        if (!result) {
+          return std::unexpected(result.error());
         }
 
-        auto validated = validate_label(ctx.punycode_decoded, ctx.use_std3_ascii_rules, ctx.check_hyphens,
-                                        ctx.check_bidi, ctx.check_joiners, false);
+        auto validated = validate_label(decoded, use_std3_ascii_rules, check_hyphens, check_bidi, check_joiners, false);
         if (!validated) {
           return std::unexpected(validated.error());
         }
       } else {
-        auto validated = validate_label(label, ctx.use_std3_ascii_rules, ctx.check_hyphens, ctx.check_bidi,
-                                        ctx.check_joiners, ctx.transitional_processing);
+        auto validated = validate_label(label, use_std3_ascii_rules, check_hyphens, check_bidi, check_joiners,
+                                        transitional_processing);
         if (!validated) {
           return std::unexpected(validated.error());
         }
       }
-
-      constexpr auto is_ascii = [](std::u32string_view input) noexcept {
-        constexpr auto is_in_ascii_set = [](auto c) { return c <= U'\x7e'; };
-
-        return std::ranges::cend(input) == std::ranges::find_if_not(input, is_in_ascii_set);
-      };
-
-      ctx.labels.emplace_back();
-      if (!is_ascii(label)) {
-        ctx.punycode_encoded.clear();
-        auto result = punycode_encode(label, &ctx.punycode_encoded);
-        if (!result) {
-          return std::unexpected(result.error());
-        }
-        std::ranges::copy(U"xn--"sv, std::back_inserter(ctx.labels.back()));
-        std::ranges::copy(ctx.punycode_encoded, std::back_inserter(ctx.labels.back()));
-      } else {
-        std::ranges::copy(label, std::back_inserter(ctx.labels.back()));
-      }
-    }
-
-    if (ctx.domain_name.back() == U'.') {
-      ctx.labels.emplace_back();
     }
 
-    return std::move(ctx);
-  };
-
-  constexpr auto check_length = [](auto&& ctx) -> std::expected<std::decay_t<decltype(ctx)>, domain_errc> {
-    constexpr auto max_domain_length = 253;
-    constexpr auto max_label_length = 63;
-
-    if (ctx.verify_dns_length) {
-      auto length = ctx.domain_name.size();
-      if ((length < 1) || (length > max_domain_length)) {
-        return std::unexpected(domain_errc::invalid_length);
-      }
-
-      for (const auto& label : ctx.labels) {
-        auto label_length = label.size();
-        if ((label_length < 1) || (label_length > max_label_length)) {
-          return std::unexpected(domain_errc::invalid_length);
-        }
+    auto label_first = encoded.size();
+    if (!details::is_ascii_label(label)) {
+      encoded.append("xn--");
+      auto result = punycode_encode(label, &encoded);
+      if (!result) {
+        return std::unexpected(result.error());
       }
+    } else {
+      std::ranges::transform(label, std::back_inserter(encoded), [](auto c) { return static_cast<char>(c); });
     }
 
-    return std::move(ctx);
-  };
+    auto label_length = encoded.size() - label_first;
+    invalid_length |= (label_length < 1) || (label_length > max_label_length);
 
-  constexpr auto copy_to_output = [](domain_to_ascii_context&& ctx) -> std::expected<void, domain_errc> {
-    for (auto it = ctx.labels.begin(); it != ctx.labels.end(); ++it) {
-      if (it != ctx.labels.begin()) {
-        ctx.ascii_domain->push_back('.');
-      }
-      std::ranges::copy(*it, std::back_inserter(*ctx.ascii_domain));
+    if (separator == std::u32string_view::npos) {
+      break;
     }
-    return {};
-  };
+    encoded.push_back('.');
+    remaining.remove_prefix(separator + 1);
+  }
 
-  return map_domain_name(std::move(context)).and_then(process_labels).and_then(check_length).and_then(copy_to_output);
-}
+  if (verify_dns_length) {
+    if (mapped.empty() || (mapped.size() > max_domain_length) || invalid_length) {
+      return std::unexpected(domain_errc::invalid_length);
+    }
+  }
 
-///
-/// \param domain_name
-/// \param ascii_domain
-/// \param check_hyphens
-/// \param check_bidi
-/// \param check_joiners
-/// \param use_std3_ascii_rules
-/// \param transitional_processing
-/// \param verify_dns_length
-/// \return
-inline auto domain_to_ascii(std::string_view domain_name, std::string* ascii_domain, bool check_hyphens,
-                            bool check_bidi, bool check_joiners, bool use_std3_ascii_rules,
-                            bool transitional_processing, bool verify_dns_length) -> std::expected<void, domain_errc> {
-  return create_domain_to_ascii_context(domain_name, ascii_domain, check_hyphens, check_bidi, check_joiners,
-                                        use_std3_ascii_rules, transitional_processing, verify_dns_length)
-      .and_then(domain_to_ascii_impl);
+  ascii_domain->append(encoded);
+  return {};
 }
 
 /// Converts a UTF-8 encoded domain to ASCII using
@@ -296,60 +239,51 @@ inline auto domain_to_ascii(std::string_view domain_name, std::string* ascii_dom
   return domain_to_ascii(domain_name, ascii_domain, false, &validation_error);
 }
 
-struct domain_to_u8_context {
-  std::string_view domain_name;
+namespace details {
+///
+/// \param domain_name
+/// \param u8_domain
+/// \return
+inline auto domain_to_u8(std::string_view domain_name, std::string* u8_domain) -> std::expected<void, domain_errc> {
+  using namespace std::string_view_literals;
 
-  /// Parameters
-  std::string* u8_domain;
+  std::array<std::byte, domain_buffer_size> buffer;
+  auto resource = std::pmr::monotonic_buffer_resource(buffer.data(), buffer.size(), std::pmr::new_delete_resource());
 
-  std::vector<std::string> labels;
+  // Labels usually decode to fewer bytes than their Punycode encoding
+  auto converted = std::pmr::string(&resource);
+  converted.reserve(domain_name.size());
+  auto decoded = std::pmr::u32string(&resource);
 
-  /// This is used as an intermediate buffer
-  std::u32string punycode_decoded;
-};
+  auto remaining = domain_name;
+  while (true) {
+    auto separator = remaining.find('.');
+    auto label = remaining.substr(0, separator);
 
-///
-/// \param context
-/// \return
-inline auto domain_to_u8_impl(domain_to_u8_context&& context) -> std::expected<void, domain_errc> {
-  static constexpr auto to_string_view = [](auto&& label) {
-    return std::string_view(std::addressof(*std::begin(label)), std::ranges::distance(label));
-  };
-
-  for (auto&& label :
-       context.domain_name | std::ranges::views::split('.') | std::ranges::views::transform(to_string_view)) {
-    context.labels.emplace_back();
-    if (label.substr(0, 4) == "xn--") {
-      label.remove_prefix(4);
-      context.punycode_decoded.clear();
-      auto result = punycode_decode(label, &context.punycode_decoded);
+    if (label.starts_with("xn--"sv)) {
+      decoded.clear();
+      auto result = punycode_decode(label.substr(4), &decoded);
       if (!result) {
         return std::unexpected(result.error());
       }
-      auto u8 = context.punycode_decoded | unicode::transforms::to_u8;
-      auto first = std::cbegin(u8);
-      auto last = std::cend(u8);
-      for (auto it = first; it != last; ++it) {
-        context.labels.back().push_back((*it).value());
+      for (auto&& code_unit : decoded | unicode::transforms::to_u8) {
+        converted.push_back(code_unit.value());
       }
     } else {
-      std::ranges::copy(label, std::back_inserter(context.labels.back()));
+      converted.append(label);
     }
-  }
-
-  if (context.domain_name.back() == U'.') {
-    context.labels.emplace_back();
-  }
 
-  for (auto it = context.labels.begin(); it != context.labels.end(); ++it) {
-    if (it != context.labels.begin()) {
-      context.u8_domain->push_back('.');
+    if (separator == std::string_view::npos) {
+      break;
     }
-    std::ranges::copy(*it, std::back_inserter(*context.u8_domain));
+    converted.push_back('.');
+    remaining.remove_prefix(separator + 1);
   }
 
+  u8_domain->append(converted);
   return {};
 }
+}  // namespace details
 
 /// Converts a Punycode encoded domain to UTF-8
 ///
@@ -359,8 +293,7 @@ inline auto domain_to_u8_impl(domain_to_u8_context&& context) -> std::expected<v
 /// \returns A valid UTF-8 encoded domain, or an error
 inline auto domain_to_u8(std::string_view domain_name, std::string* u8_domain, [[maybe_unused]] bool* validation_error)
     -> std::expected<void, domain_errc> {
-  auto context = domain_to_u8_context{domain_name, u8_domain, {}, {}};
-  return domain_to_u8_impl(std::move(context));
+  return details::domain_to_u8(domain_name, u8_domain);
 }
 
 /// Converts a Punycode encoded domain to UTF-8
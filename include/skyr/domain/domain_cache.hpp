@@ -0,0 +1,289 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_DOMAIN_DOMAIN_CACHE_HPP
+#define SKYR_DOMAIN_DOMAIN_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+#include <skyr/domain/domain.hpp>
+#include <skyr/domain/errors.hpp>
+
+/// \file domain_cache.hpp
+/// A bounded cache of `domain_to_ascii` and `domain_to_u8` results, for
+/// applications that parse the same hosts over and over again
+
+namespace skyr {
+/// Counters for a `domain_cache`
+struct domain_cache_stats {
+  /// The number of lookups that found a cached result
+  std::uint64_t hits = 0;
+  /// The number of lookups that had to convert the domain
+  std::uint64_t misses = 0;
+  /// The number of results that were replaced by newer results
+  std::uint64_t evictions = 0;
+};
+
+/// A bounded, thread safe cache of the results of `domain_to_ascii` and
+/// `domain_to_u8`, including errors.
+///
+/// The cache is split into shards, each with its own lock, so that
+/// threads converting different domains rarely contend. Lookups take a
+/// shared lock, so they never wait for each other, and only a miss takes
+/// an exclusive lock to store its result. When a shard is full, the
+/// result to replace is chosen with the CLOCK algorithm: each lookup
+/// marks the result it finds without taking an exclusive lock, and
+/// results that haven't been marked since the clock hand last passed are
+/// replaced first.
+///
+/// The cache is used by the URL parser once it is installed with
+/// `skyr::set_domain_cache`:
+///
+/// ```
+/// static auto cache = skyr::domain_cache(100'000);
+/// skyr::set_domain_cache(&cache);
+/// auto url = skyr::url("https://例子.测试/");  // Converted and cached
+/// ```
+class domain_cache {
+ public:
+  /// The default number of shards
+  static constexpr std::size_t default_shard_count = 64;
+
+  /// Constructor
+  ///
+  /// \param capacity The maximum number of results to cache, shared
+  ///        between both directions
+  /// \param shard_count The number of independently locked shards
+  explicit domain_cache(std::size_t capacity, std::size_t shard_count = default_shard_count)
+      : shard_count_(std::max(std::min(shard_count, capacity), std::size_t{1})),
+        shards_(std::make_unique<shard[]>(shard_count_)) {
+    // Spread the capacity over the shards, so that no shard is empty
+    auto shard_capacity = std::max(capacity / shard_count_, std::size_t{1});
+    for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+      shards_[i].entries = std::make_unique<entry[]>(shard_capacity);
+      shards_[i].capacity = shard_capacity;
+    }
+  }
+
+  domain_cache(const domain_cache&) = delete;
+  domain_cache& operator=(const domain_cache&) = delete;
+
+  /// Converts a UTF-8 encoded domain to ASCII, as `domain_to_ascii` does,
+  /// or returns the cached result of an earlier conversion
+  ///
+  /// \param domain_name A domain
+  /// \param ascii_domain Output pointer to store the ASCII domain
+  /// \returns An error if the domain can't be converted
+  auto to_ascii(std::string_view domain_name, std::string* ascii_domain) -> std::expected<void, domain_errc> {
+    return convert(direction::to_ascii, domain_name, ascii_domain,
+                   [](std::string_view input, std::string* output) { return domain_to_ascii(input, output); });
+  }
+
+  /// Converts a Punycode encoded domain to UTF-8, as `domain_to_u8` does,
+  /// or returns the cached result of an earlier conversion
+  ///
+  /// \param domain_name A Punycode encoded domain
+  /// \param u8_domain Output pointer to store the UTF-8 domain
+  /// \returns An error if the domain can't be converted
+  auto to_u8(std::string_view domain_name, std::string* u8_domain) -> std::expected<void, domain_errc> {
+    return convert(direction::to_u8, domain_name, u8_domain,
+                   [](std::string_view input, std::string* output) { return domain_to_u8(input, output); });
+  }
+
+  /// \returns The hit, miss and eviction counters, summed over all shards
+  [[nodiscard]] auto stats() const noexcept -> domain_cache_stats {
+    auto result = domain_cache_stats{};
+    for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+      result.hits += shards_[i].hits.load(std::memory_order_relaxed);
+      result.misses += shards_[i].misses.load(std::memory_order_relaxed);
+      result.evictions += shards_[i].evictions.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /// \returns The number of cached results
+  [[nodiscard]] auto size() const -> std::size_t {
+    auto result = std::size_t{0};
+    for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+      auto lock = std::shared_lock(shards_[i].mutex);
+      result += shards_[i].size;
+    }
+    return result;
+  }
+
+  /// Removes every cached result and resets the counters
+  void clear() {
+    for (auto i = std::size_t{0}; i < shard_count_; ++i) {
+      auto& current = shards_[i];
+      auto lock = std::unique_lock(current.mutex);
+      for (auto& index : current.indices) {
+        index.clear();
+      }
+      for (auto j = std::size_t{0}; j < current.size; ++j) {
+        current.entries[j].key.clear();
+        current.entries[j].result = std::string{};
+      }
+      current.size = 0;
+      current.hand = 0;
+      current.hits.store(0, std::memory_order_relaxed);
+      current.misses.store(0, std::memory_order_relaxed);
+      current.evictions.store(0, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  enum class direction : std::size_t {
+    to_ascii,
+    to_u8,
+  };
+
+  struct entry {
+    direction kind = direction::to_ascii;
+    std::string key;
+    std::expected<std::string, domain_errc> result;
+    std::atomic<bool> referenced = false;
+  };
+
+  struct alignas(64) shard {
+    mutable std::shared_mutex mutex;
+    // The keys refer to the keys of the entries, which are never moved
+    std::array<std::unordered_map<std::string_view, std::size_t>, 2> indices;
+    std::unique_ptr<entry[]> entries;
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t hand = 0;
+    std::atomic<std::uint64_t> hits = 0;
+    std::atomic<std::uint64_t> misses = 0;
+    std::atomic<std::uint64_t> evictions = 0;
+  };
+
+  static auto assign(const std::expected<std::string, domain_errc>& result, std::string* output)
+      -> std::expected<void, domain_errc> {
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+    output->assign(result.value());
+    return {};
+  }
+
+  template <class Convert>
+  auto convert(direction kind, std::string_view domain_name, std::string* output, Convert convert)
+      -> std::expected<void, domain_errc> {
+    auto& current = shards_[std::hash<std::string_view>{}(domain_name) % shard_count_];
+    auto& index = current.indices[static_cast<std::size_t>(kind)];
+
+    {
+      auto lock = std::shared_lock(current.mutex);
+      if (auto it = index.find(domain_name); it != index.end()) {
+        auto& cached = current.entries[it->second];
+        cached.referenced.store(true, std::memory_order_relaxed);
+        current.hits.fetch_add(1, std::memory_order_relaxed);
+        return assign(cached.result, output);
+      }
+    }
+    current.misses.fetch_add(1, std::memory_order_relaxed);
+
+    // Convert without holding the lock, so that lookups aren't blocked
+    auto converted = std::string{};
+    auto result = convert(domain_name, &converted);
+    auto value = result ? std::expected<std::string, domain_errc>(std::move(converted))
+                        : std::expected<std::string, domain_errc>(std::unexpected(result.error()));
+
+    auto lock = std::unique_lock(current.mutex);
+    if (!index.contains(domain_name)) {
+      insert(current, kind, domain_name, value);
+    }
+    return assign(value, output);
+  }
+
+  static void insert(shard& current, direction kind, std::string_view domain_name,
+                     const std::expected<std::string, domain_errc>& value) {
+    auto slot = current.size;
+    if (current.size < current.capacity) {
+      ++current.size;
+    } else {
+      // Give each result that was looked up since the hand last passed a
+      // second chance
+      while (current.entries[current.hand].referenced.exchange(false, std::memory_order_relaxed)) {
+        current.hand = (current.hand + 1) % current.capacity;
+      }
+      slot = current.hand;
+      current.hand = (current.hand + 1) % current.capacity;
+
+      auto& evicted = current.entries[slot];
+      current.indices[static_cast<std::size_t>(evicted.kind)].erase(evicted.key);
+      current.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto& inserted = current.entries[slot];
+    inserted.kind = kind;
+    inserted.key.assign(domain_name);
+    inserted.result = value;
+    inserted.referenced.store(false, std::memory_order_relaxed);
+    current.indices[static_cast<std::size_t>(kind)].emplace(inserted.key, slot);
+  }
+
+  std::size_t shard_count_;
+  std::unique_ptr<shard[]> shards_;
+};
+
+namespace details {
+inline auto installed_domain_cache = std::atomic<domain_cache*>{nullptr};
+}  // namespace details
+
+/// Installs a cache that is used to convert domains when parsing URLs and
+/// by `skyr::url::u8domain`
+///
+/// \param cache The cache, which must outlive every use, or `nullptr` to
+///        stop using a cache
+/// \returns The previously installed cache, or `nullptr`
+inline auto set_domain_cache(domain_cache* cache) noexcept -> domain_cache* {
+  return details::installed_domain_cache.exchange(cache, std::memory_order_acq_rel);
+}
+
+/// \returns The cache installed with `set_domain_cache`, or `nullptr`
+inline auto get_domain_cache() noexcept -> domain_cache* {
+  return details::installed_domain_cache.load(std::memory_order_acquire);
+}
+
+/// Converts a UTF-8 encoded domain to ASCII using the installed cache, if
+/// any
+///
+/// \param domain_name A domain
+/// \param ascii_domain Output pointer to store the ASCII domain
+/// \returns An error if the domain can't be converted
+inline auto cached_domain_to_ascii(std::string_view domain_name, std::string* ascii_domain)
+    -> std::expected<void, domain_errc> {
+  auto cache = get_domain_cache();
+  return cache ? cache->to_ascii(domain_name, ascii_domain) : domain_to_ascii(domain_name, ascii_domain);
+}
+
+/// Converts a Punycode encoded domain to UTF-8 using the installed cache,
+/// if any
+///
+/// \param domain_name A Punycode encoded domain
+/// \param u8_domain Output pointer to store the UTF-8 domain
+/// \returns An error if the domain can't be converted
+inline auto cached_domain_to_u8(std::string_view domain_name, std::string* u8_domain)
+    -> std::expected<void, domain_errc> {
+  auto cache = get_domain_cache();
+  return cache ? cache->to_u8(domain_name, u8_domain) : domain_to_u8(domain_name, u8_domain);
+}
+}  // namespace skyr
+
+#endif  // SKYR_DOMAIN_DOMAIN_CACHE_HPP
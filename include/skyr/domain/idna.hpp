@@ -6,60 +6,81 @@
 #ifndef SKYR_DOMAIN_IDNA_HPP
 #define SKYR_DOMAIN_IDNA_HPP
 
+#include <algorithm>
+#include <cstddef>
 #include <expected>
+#include <iterator>
+#include <string_view>
 
 #include <skyr/domain/errors.hpp>
+#include <skyr/domain/idna_status.hpp>
 #include <skyr/domain/idna_tables.hpp>
-#include <skyr/unicode/traits/range_iterator.hpp>
 
 namespace skyr::idna {
-///
-/// \param code_point A code point value
-/// \return The status of the code point
-constexpr auto code_point_status(char32_t code_point) -> idna_status {
-  constexpr auto less = [](const auto& range, auto code_point) { return range.last < code_point; };
-
-  auto first = std::cbegin(details::statuses), last = std::cend(details::statuses);
-  auto it = std::lower_bound(first, last, code_point, less);
-  return (it == last) || !((code_point >= (*it).first) && (code_point <= (*it).last)) ? idna_status::valid : it->status;
-}
-
 namespace details {
-constexpr auto map_code_point_16(char16_t code_point) -> char16_t {
-  constexpr auto less = [](const auto& lhs, auto rhs) { return lhs.code_point < rhs; };
+/// Looks up the value of a code point in a three-stage table, using three
+/// loads: the block of the code point, the leaf in that block, and the value
+/// in that leaf
+///
+/// \tparam LeafShift The log2 of the number of values in each leaf
+/// \tparam IndexShift The log2 of the number of leaves in each block
+/// \param stage_1 The index of each block
+/// \param stage_2 The deduplicated blocks of leaf indices
+/// \param stage_3 The deduplicated leaves of values
+/// \param code_point A code point value, no greater than U+10FFFF
+/// \returns The value of the code point
+template <unsigned LeafShift, unsigned IndexShift, class Stage1, class Stage2, class Stage3>
+constexpr auto three_stage_lookup(const Stage1& stage_1, const Stage2& stage_2, const Stage3& stage_3,
+                                  char32_t code_point) noexcept {
+  constexpr auto leaf_mask = (char32_t{1} << LeafShift) - 1;
+  constexpr auto index_mask = (char32_t{1} << IndexShift) - 1;
 
-  auto first = std::cbegin(mapped_16), last = std::cend(mapped_16);
-  auto it = std::lower_bound(first, last, code_point, less);
-  return (it != last) ? it->mapped : code_point;
+  auto block = std::size_t{stage_1[code_point >> (LeafShift + IndexShift)]};
+  auto leaf = std::size_t{stage_2[(block << IndexShift) | ((code_point >> LeafShift) & index_mask)]};
+  return stage_3[(leaf << LeafShift) | (code_point & leaf_mask)];
 }
 }  // namespace details
 
 ///
 /// \param code_point A code point value
-/// \return The code point or mapped value, depending on the status of the code
-/// point
-constexpr auto map_code_point(char32_t code_point) -> char32_t {
-  constexpr auto less = [](const auto& lhs, auto rhs) { return lhs.code_point < rhs; };
-
-  if (code_point <= U'\xffff') {
-    return static_cast<char32_t>(details::map_code_point_16(static_cast<char16_t>(code_point)));
+/// \return The status of the code point
+constexpr auto code_point_status(char32_t code_point) noexcept -> idna_status {
+  if (code_point > U'\x10ffff') {
+    return idna_status::disallowed;
   }
+  return static_cast<idna_status>(
+      details::three_stage_lookup<details::status_leaf_shift, details::status_index_shift>(
+          details::status_stage_1, details::status_stage_2, details::status_stage_3, code_point));
+}
 
-  auto first = std::cbegin(details::mapped_32), last = std::cend(details::mapped_32);
-  auto it = std::lower_bound(first, last, code_point, less);
-  return (it != last) ? it->mapped : code_point;
+///
+/// \param code_point A code point value
+/// \return The mapped value of a code point that is mapped, or that is a
+/// deviation, or an empty string if the code point isn't mapped
+constexpr auto map_code_point(char32_t code_point) noexcept -> std::u32string_view {
+  if (code_point > U'\x10ffff') {
+    return {};
+  }
+  auto index = details::three_stage_lookup<details::mapped_leaf_shift, details::mapped_index_shift>(
+      details::mapped_stage_1, details::mapped_stage_2, details::mapped_stage_3, code_point);
+  return std::u32string_view(details::mapped_pool.data(), details::mapped_pool.size())
+      .substr(details::mapped_offsets[index], details::mapped_lengths[index]);
 }
 
+/// Maps a sequence of code points, where a code point can be mapped to
+/// more than one code point, or removed
 ///
-/// \tparam FwdIter
+/// \tparam InputIter
+/// \tparam OutputIter
 /// \param first
 /// \param last
+/// \param out
 /// \param use_std3_ascii_rules
 /// \param transitional_processing
-/// \return
-template <class FwdIter>
-inline auto map_code_points(FwdIter first, FwdIter last, bool use_std3_ascii_rules, bool transitional_processing)
-    -> std::expected<FwdIter, domain_errc> {
+/// \return The end of the output range, or an error
+template <class InputIter, class OutputIter>
+inline auto map_code_points(InputIter first, InputIter last, OutputIter out, bool use_std3_ascii_rules,
+                            bool transitional_processing) -> std::expected<OutputIter, domain_errc> {
   for (auto it = first; it != last; ++it) {
     switch (code_point_status(*it)) {
       case idna_status::disallowed:
@@ -68,40 +89,41 @@ inline auto map_code_points(FwdIter first, FwdIter last, bool use_std3_ascii_rul
         if (use_std3_ascii_rules) {
           return std::unexpected(domain_errc::disallowed_code_point);
         } else {
-          *first++ = *it;
+          *out++ = *it;
         }
         break;
       case idna_status::disallowed_std3_mapped:
         if (use_std3_ascii_rules) {
           return std::unexpected(domain_errc::disallowed_code_point);
         } else {
-          *first++ = map_code_point(*it);
+          out = std::ranges::copy(map_code_point(*it), out).out;
         }
         break;
       case idna_status::ignored:
         break;
       case idna_status::mapped:
-        *first++ = idna::map_code_point(*it);
+        out = std::ranges::copy(idna::map_code_point(*it), out).out;
         break;
       case idna_status::deviation:
         if (transitional_processing) {
-          *first++ = idna::map_code_point(*it);
+          out = std::ranges::copy(idna::map_code_point(*it), out).out;
         } else {
-          *first++ = *it;
+          *out++ = *it;
         }
         break;
       case idna_status::valid:
-        *first++ = *it;
+        *out++ = *it;
         break;
     }
   }
-  return first;
+  return out;
 }
 
-template <class T>
-inline auto map_code_points(T& code_points, bool use_std3_ascii_rules, bool transitional_processing)
-    -> std::expected<typename unicode::traits::range_iterator_t<T>, domain_errc> {
-  return map_code_points(std::begin(code_points), std::end(code_points), use_std3_ascii_rules, transitional_processing);
+template <class T, class OutputIter>
+inline auto map_code_points(const T& code_points, OutputIter out, bool use_std3_ascii_rules,
+                            bool transitional_processing) -> std::expected<OutputIter, domain_errc> {
+  return map_code_points(std::begin(code_points), std::end(code_points), out, use_std3_ascii_rules,
+                         transitional_processing);
 }
 }  // namespace skyr::idna
 
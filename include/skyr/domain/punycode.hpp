@@ -7,9 +7,12 @@
 #define SKYR_DOMAIN_PUNYCODE_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <limits>
+#include <memory_resource>
 #include <ranges>
 #include <string>
 #include <string_view>
@@ -49,9 +52,10 @@ constexpr inline auto adapt(uint32_t delta, uint32_t numpoints, bool firsttime)
 /// defined in [RFC 3492](https://tools.ietf.org/html/rfc3492)
 ///
 /// \param input A UTF-32 encoded domain
-/// \param output An ascii string on output
+/// \param output An ascii string, which the encoded domain is appended to
 /// \returns `void` or an error
-inline auto punycode_encode(std::u32string_view input, std::string* output) -> std::expected<void, domain_errc> {
+template <class String>
+inline auto punycode_encode(std::u32string_view input, String* output) -> std::expected<void, domain_errc> {
   using namespace punycode::constants;
 
   constexpr auto is_ascii_value = [](auto c) { return c < 0x80; };
@@ -76,18 +80,23 @@ inline auto punycode_encode(std::u32string_view input, std::string* output) -> s
   auto delta = 0ul;
   auto bias = initial_bias;
 
+  auto output_first = output->size();
   auto ascii_values = input | std::ranges::views::filter(is_ascii_value) | std::ranges::views::transform(to_char);
   std::copy(std::begin(ascii_values), std::end(ascii_values), std::back_inserter(*output));
 
-  auto h = static_cast<uint32_t>(output->size());
-  auto b = static_cast<uint32_t>(output->size());
+  auto h = static_cast<uint32_t>(output->size() - output_first);
+  auto b = h;
 
   if (b != 0ul) {
     *output += static_cast<char>(delimiter);
   }
 
-  // Optimization: Pre-compute sorted unique non-ASCII codepoints to avoid O(n²) scanning
-  auto unique_codepoints = std::vector<char32_t>{};
+  // Optimization: Pre-compute sorted unique non-ASCII codepoints to avoid O(n²) scanning. They are stored on the
+  // stack, unless the label is much longer than a valid DNS label.
+  std::array<std::byte, 64 * sizeof(char32_t)> buffer;
+  auto resource = std::pmr::monotonic_buffer_resource(buffer.data(), buffer.size(), std::pmr::new_delete_resource());
+  auto unique_codepoints = std::pmr::vector<char32_t>(&resource);
+  unique_codepoints.reserve(input.size());
   for (auto c : input) {
     if (c >= initial_n) {
       unique_codepoints.push_back(c);
@@ -151,10 +160,10 @@ inline auto punycode_encode(std::u32string_view input, std::string* output) -> s
 /// defined in [RFC 3492](https://tools.ietf.org/html/rfc3492)
 ///
 /// \param input An ASCII encoded domain to be decoded
-/// \param output The output UTF-32 string to store the decoded result
+/// \param output A UTF-32 string, which the decoded domain is appended to
 /// \returns The decoded UTF-8 domain, or an error
-template <class StringView>
-constexpr inline auto punycode_decode(StringView input, std::u32string* output) -> std::expected<void, domain_errc> {
+template <class StringView, class U32String>
+constexpr inline auto punycode_decode(StringView input, U32String* output) -> std::expected<void, domain_errc> {
   using namespace punycode::constants;
 
   // decode_digit(cp) returns the numeric value of a basic code
@@ -183,6 +192,7 @@ constexpr inline auto punycode_decode(StringView input, std::u32string* output)
   auto n = initial_n;
   auto bias = initial_bias;
 
+  auto output_first = output->size();
   auto delim_index = input.find_last_of(delimiter);
   delim_index = (delim_index == decltype(input)::npos) ? 0ul : delim_index;
   auto ascii_values = input | std::ranges::views::take(delim_index);
@@ -218,7 +228,7 @@ constexpr inline auto punycode_decode(StringView input, std::u32string* output)
       k += base;
     }
 
-    auto out = output->size() + 1ul;
+    auto out = output->size() - output_first + 1ul;
     bias = punycode::adapt((i - oldi), out, (oldi == 0ul));
 
     if ((i / out) > (std::numeric_limits<uint32_t>::max() - n)) {
@@ -227,7 +237,7 @@ constexpr inline auto punycode_decode(StringView input, std::u32string* output)
     n += i / out;
     i %= out;
 
-    output->insert(i++, 1, static_cast<char32_t>(n));
+    output->insert(output_first + i++, 1, static_cast<char32_t>(n));
   }
 
   return {};
@@ -8,6 +8,7 @@
 
 #include <expected>
 #include <filesystem>
+#include <utility>
 
 #include <skyr/percent_encoding/percent_decode.hpp>
 #include <skyr/url.hpp>
@@ -46,11 +47,10 @@ inline auto from_path(const std::filesystem::path& path) -> std::expected<url, u
 /// \returns a path object or an error on failure
 inline auto to_path(const url& input) -> std::expected<std::filesystem::path, path_errc> {
   auto pathname = input.pathname();
-  auto decoded = ::skyr::percent_decode(pathname);
-  if (!decoded) {
+  if (!::skyr::percent_decode_in_place(pathname)) {
     return std::unexpected(path_errc::percent_decoding_error);
   }
-  return std::filesystem::path(decoded.value());
+  return std::filesystem::path(std::move(pathname));
 }
 }  // namespace filesystem
 }  // namespace skyr
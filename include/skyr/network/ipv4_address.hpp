@@ -13,6 +13,7 @@
 #include <cstdint>
 #include <expected>
 #include <format>
+#include <functional>
 #include <locale>
 #include <optional>
 #include <ranges>
@@ -77,6 +78,12 @@ class ipv4_address {
     }
     return output;
   }
+
+  /// Compares two addresses
+  /// \param lhs An IPv4 address
+  /// \param rhs An IPv4 address
+  /// \returns `true` if the addresses are equal
+  friend constexpr auto operator==(const ipv4_address& lhs, const ipv4_address& rhs) noexcept -> bool = default;
 };
 
 namespace details {
@@ -193,4 +200,15 @@ constexpr inline auto parse_ipv4_address(std::string_view input, bool* validatio
 }
 }  // namespace skyr
 
+namespace std {
+/// Hashes a skyr::ipv4_address, so that addresses can be used as keys in
+/// unordered containers
+template <>
+struct hash<skyr::ipv4_address> {
+  auto operator()(const skyr::ipv4_address& address) const noexcept -> std::size_t {
+    return std::hash<unsigned int>{}(address.address());
+  }
+};
+}  // namespace std
+
 #endif  // SKYR_NETWORK_IPV4_ADDRESS_HPP
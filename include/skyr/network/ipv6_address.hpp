@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <expected>
 #include <format>
+#include <functional>
 #include <iterator>
 #include <locale>
 #include <optional>
@@ -141,6 +142,12 @@ class ipv6_address {
 
     return output;
   }
+
+  /// Compares two addresses
+  /// \param lhs An IPv6 address
+  /// \param rhs An IPv6 address
+  /// \returns `true` if the addresses are equal
+  friend constexpr auto operator==(const ipv6_address& lhs, const ipv6_address& rhs) noexcept -> bool = default;
 };
 
 namespace details {
@@ -303,4 +310,17 @@ constexpr inline auto parse_ipv6_address(std::string_view input, bool* validatio
 }
 }  // namespace skyr
 
+namespace std {
+/// Hashes a skyr::ipv6_address, so that addresses can be used as keys in
+/// unordered containers
+template <>
+struct hash<skyr::ipv6_address> {
+  auto operator()(const skyr::ipv6_address& address) const noexcept -> std::size_t {
+    auto bytes = address.to_bytes();
+    auto view = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());  // NOLINT
+    return std::hash<std::string_view>{}(view);
+  }
+};
+}  // namespace std
+
 #endif  // SKYR_NETWORK_IPV6_ADDRESS_HPP
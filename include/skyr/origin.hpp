@@ -0,0 +1,312 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_ORIGIN_HPP
+#define SKYR_ORIGIN_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <format>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include <skyr/core/errors.hpp>
+#include <skyr/core/host.hpp>
+#include <skyr/core/parse.hpp>
+#include <skyr/core/url_record.hpp>
+#include <skyr/details/url_storage.hpp>
+#include <skyr/network/ipv4_address.hpp>
+#include <skyr/network/ipv6_address.hpp>
+
+/// \file origin.hpp
+/// Provides skyr::origin, the [origin](https://html.spec.whatwg.org/multipage/browsers.html#origin)
+/// of a URL as a value type
+
+namespace skyr {
+class url;
+
+/// The scheme of a tuple origin
+enum class origin_scheme : std::uint8_t {
+  ftp,
+  http,
+  https,
+  ws,
+  wss,
+};
+
+namespace details {
+/// \param scheme A URL scheme
+/// \returns The origin scheme, or `std::nullopt` if the scheme does not have a tuple origin
+constexpr inline auto to_origin_scheme(std::string_view scheme) noexcept -> std::optional<origin_scheme> {
+  using namespace std::string_view_literals;
+  if (scheme == "https"sv) {
+    return origin_scheme::https;
+  } else if (scheme == "http"sv) {
+    return origin_scheme::http;
+  } else if (scheme == "wss"sv) {
+    return origin_scheme::wss;
+  } else if (scheme == "ws"sv) {
+    return origin_scheme::ws;
+  } else if (scheme == "ftp"sv) {
+    return origin_scheme::ftp;
+  }
+  return std::nullopt;
+}
+
+/// \param scheme An origin scheme
+/// \returns The scheme name
+constexpr inline auto origin_scheme_name(origin_scheme scheme) noexcept -> std::string_view {
+  using namespace std::string_view_literals;
+  constexpr auto names = std::array{"ftp"sv, "http"sv, "https"sv, "ws"sv, "wss"sv};
+  return names[static_cast<std::size_t>(scheme)];
+}
+
+/// Each opaque origin is distinct from every other, so each is given a unique identifier
+inline auto next_opaque_origin_id() noexcept -> std::uint64_t {
+  static auto next_id = std::atomic<std::uint64_t>{0};
+  return next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+}  // namespace details
+
+/// Represents the [origin](https://html.spec.whatwg.org/multipage/browsers.html#origin)
+/// of a URL.
+///
+/// An origin is either a tuple of scheme, host and port, or opaque. Tuple
+/// origins are compared and hashed without building a string; `serialize`
+/// builds the string form on demand. An origin constructed from a `skyr::url`
+/// shares the URL's storage rather than copying the domain name.
+///
+/// Opaque origins are only equal to copies of themselves.
+class origin {
+ public:
+  /// Constructs a new opaque origin
+  origin() noexcept : opaque_id_(details::next_opaque_origin_id()) {
+  }
+
+  /// Constructs the origin of a URL
+  /// \param url A URL
+  explicit origin(const url& url);
+
+  /// Constructs the origin of a URL record
+  /// \param record A URL record
+  explicit origin(const url_record& record) {
+    if (record.scheme == "blob") {
+      if (!record.path.empty()) {
+        auto path_record = skyr::parse(record.path.front());
+        if (path_record) {
+          *this = origin(path_record.value());
+          return;
+        }
+      }
+      opaque_id_ = details::next_opaque_origin_id();
+      return;
+    }
+
+    auto scheme = details::to_origin_scheme(record.scheme);
+    if (!scheme || !record.host) {
+      opaque_id_ = details::next_opaque_origin_id();
+      return;
+    }
+
+    auto domain = std::string_view{};
+    if (record.host.value().is_domain_name()) {
+      name_ = std::make_shared<const std::string>(record.host.value().serialize());
+      domain = *name_;
+    }
+    set_tuple(scheme.value(), record.host.value(), record.port, domain);
+  }
+
+  /// Parses the value of an HTTP `Origin` header, which is either "null"
+  /// or the serialization of a tuple origin
+  ///
+  /// \param input An origin string, e.g. "https://example.com:8443"
+  /// \returns An origin on success, or an error code
+  static auto parse(std::string_view input) -> std::expected<origin, url_parse_errc> {
+    using namespace std::string_view_literals;
+    if (input == "null"sv) {
+      return origin();
+    }
+
+    auto scheme_end = input.find("://"sv);
+    if (scheme_end == std::string_view::npos) {
+      return std::unexpected(url_parse_errc::invalid_origin);
+    }
+    if (input.find_first_of("/?#@\\"sv, scheme_end + 3) != std::string_view::npos) {
+      return std::unexpected(url_parse_errc::invalid_origin);
+    }
+
+    auto record = skyr::parse(input);
+    if (!record) {
+      return std::unexpected(record.error());
+    }
+    if (!details::to_origin_scheme(record.value().scheme)) {
+      return std::unexpected(url_parse_errc::invalid_origin);
+    }
+    return origin(record.value());
+  }
+
+  /// \returns `true` if this is an opaque origin
+  [[nodiscard]] auto is_opaque() const noexcept -> bool {
+    return std::holds_alternative<std::monostate>(host_);
+  }
+
+  /// \returns The scheme of a tuple origin
+  [[nodiscard]] auto scheme() const noexcept -> std::optional<origin_scheme> {
+    return is_opaque() ? std::nullopt : std::make_optional(scheme_);
+  }
+
+  /// \returns The scheme name of a tuple origin, or an empty string
+  [[nodiscard]] auto scheme_name() const noexcept -> std::string_view {
+    return is_opaque() ? std::string_view{} : details::origin_scheme_name(scheme_);
+  }
+
+  /// \returns The host of a tuple origin
+  [[nodiscard]] auto host() const -> std::optional<skyr::host> {
+    if (auto address = std::get_if<ipv4_address>(&host_)) {
+      return skyr::host{*address};
+    } else if (auto address = std::get_if<ipv6_address>(&host_)) {
+      return skyr::host{*address};
+    } else if (auto domain = std::get_if<std::string_view>(&host_)) {
+      return skyr::host{domain_name{std::string(*domain)}};
+    }
+    return std::nullopt;
+  }
+
+  /// \returns The domain name of a tuple origin, or an empty string
+  ///          if the host is an IP address
+  [[nodiscard]] auto domain() const noexcept -> std::string_view {
+    auto domain = std::get_if<std::string_view>(&host_);
+    return domain ? *domain : std::string_view{};
+  }
+
+  /// \returns The port of a tuple origin, which is empty if it is the
+  ///          default port for the scheme
+  [[nodiscard]] auto port() const noexcept -> std::optional<std::uint16_t> {
+    return port_;
+  }
+
+  /// Serializes the origin according to the
+  /// [HTML specification](https://html.spec.whatwg.org/multipage/browsers.html#ascii-serialisation-of-an-origin)
+  ///
+  /// \returns "null" for an opaque origin, otherwise `scheme://host[:port]`
+  [[nodiscard]] auto serialize() const -> std::string {
+    if (is_opaque()) {
+      return "null";
+    }
+
+    auto result = std::string{};
+    auto host = std::string{};
+    if (auto address = std::get_if<ipv4_address>(&host_)) {
+      host = address->serialize();
+    } else if (auto address = std::get_if<ipv6_address>(&host_)) {
+      host = std::format("[{}]", address->serialize());
+    }
+    auto hostname = host.empty() ? domain() : std::string_view(host);
+    auto scheme = scheme_name();
+
+    result.reserve(scheme.size() + 3 + hostname.size() + (port_ ? 6 : 0));
+    result.append(scheme);
+    result.append("://");
+    result.append(hostname);
+    if (port_) {
+      std::format_to(std::back_inserter(result), ":{}", port_.value());
+    }
+    return result;
+  }
+
+  /// \returns A hash value that is consistent with `operator==`
+  [[nodiscard]] auto hash() const noexcept -> std::size_t {
+    if (is_opaque()) {
+      return std::hash<std::uint64_t>{}(opaque_id_);
+    }
+
+    auto seed = static_cast<std::size_t>(scheme_);
+    seed = details::hash_combine(seed, port_ ? port_.value() : 0x10000u);
+    if (auto address = std::get_if<ipv4_address>(&host_)) {
+      seed = details::hash_combine(seed, std::hash<ipv4_address>{}(*address));
+    } else if (auto address = std::get_if<ipv6_address>(&host_)) {
+      seed = details::hash_combine(seed, std::hash<ipv6_address>{}(*address));
+    } else {
+      seed = details::hash_combine(seed, std::hash<std::string_view>{}(domain()));
+    }
+    return seed;
+  }
+
+  /// Tests whether two origins are the
+  /// [same origin](https://html.spec.whatwg.org/multipage/browsers.html#same-origin)
+  /// \param lhs An origin
+  /// \param rhs An origin
+  /// \returns `true` if the origins are the same
+  friend auto operator==(const origin& lhs, const origin& rhs) noexcept -> bool {
+    if (lhs.is_opaque() || rhs.is_opaque()) {
+      return lhs.is_opaque() && rhs.is_opaque() && (lhs.opaque_id_ == rhs.opaque_id_);
+    }
+
+    if ((lhs.scheme_ != rhs.scheme_) || (lhs.port_ != rhs.port_) || (lhs.host_.index() != rhs.host_.index())) {
+      return false;
+    }
+
+    if (auto address = std::get_if<ipv4_address>(&lhs.host_)) {
+      return *address == std::get<ipv4_address>(rhs.host_);
+    } else if (auto address = std::get_if<ipv6_address>(&lhs.host_)) {
+      return *address == std::get<ipv6_address>(rhs.host_);
+    }
+    return lhs.domain() == rhs.domain();
+  }
+
+ private:
+  void set_tuple(origin_scheme scheme, const skyr::host& host, std::optional<std::uint16_t> port,
+                 std::string_view domain) {
+    scheme_ = scheme;
+    port_ = port;
+    opaque_id_ = 0;
+    if (auto address = host.to_ipv4_address()) {
+      host_ = address.value();
+    } else if (auto address = host.to_ipv6_address()) {
+      host_ = address.value();
+    } else {
+      host_ = domain;
+    }
+  }
+
+  std::variant<std::monostate, ipv4_address, ipv6_address, std::string_view> host_;
+  /// The storage of the URL that the domain is borrowed from
+  details::url_storage_ptr storage_;
+  /// The domain, if it isn't borrowed from a URL
+  std::shared_ptr<const std::string> name_;
+  std::uint64_t opaque_id_ = 0;
+  std::optional<std::uint16_t> port_;
+  origin_scheme scheme_ = origin_scheme::http;
+};
+}  // namespace skyr
+
+namespace std {
+/// Hashes a skyr::origin, so that origins can be used as keys in
+/// unordered containers
+template <>
+struct hash<skyr::origin> {
+  auto operator()(const skyr::origin& origin) const noexcept -> std::size_t {
+    return origin.hash();
+  }
+};
+
+/// Formats a skyr::origin as its serialization
+template <>
+struct formatter<skyr::origin> : formatter<std::string_view> {
+  auto format(const skyr::origin& origin, std::format_context& ctx) const {
+    return formatter<std::string_view>::format(origin.serialize(), ctx);
+  }
+};
+}  // namespace std
+
+#endif  // SKYR_ORIGIN_HPP
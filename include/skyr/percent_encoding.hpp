@@ -5,8 +5,10 @@
 #ifndef SKYR_URL_PERCENT_ENCODING_HPP
 #define SKYR_URL_PERCENT_ENCODING_HPP
 
+#include <skyr/percent_encoding/decoded_view.hpp>
 #include <skyr/percent_encoding/errors.hpp>
 #include <skyr/percent_encoding/percent_decode.hpp>
+#include <skyr/percent_encoding/percent_decode_utf8.hpp>
 #include <skyr/percent_encoding/percent_encode.hpp>
 
 #endif  // SKYR_URL_PERCENT_ENCODING_HPP
@@ -0,0 +1,511 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_PERCENT_ENCODING_BYTE_SET_HPP
+#define SKYR_PERCENT_ENCODING_BYTE_SET_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include <skyr/percent_encoding/percent_encoded_char.hpp>
+
+#if !defined(SKYR_PERCENT_ENCODING_NO_SIMD)
+#  if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    define SKYR_PERCENT_ENCODING_X86_DISPATCH
+#    define SKYR_PERCENT_ENCODING_AVX2
+#    define SKYR_PERCENT_ENCODING_SSSE3
+#    include <immintrin.h>
+#  elif defined(__AVX2__)
+#    define SKYR_PERCENT_ENCODING_AVX2
+#    include <immintrin.h>
+#  elif defined(__SSSE3__)
+#    define SKYR_PERCENT_ENCODING_SSSE3
+#    include <tmmintrin.h>
+#  elif defined(__ARM_NEON) && defined(__aarch64__)
+#    define SKYR_PERCENT_ENCODING_NEON
+#    include <arm_neon.h>
+#  endif
+#endif  // !defined(SKYR_PERCENT_ENCODING_NO_SIMD)
+
+#if defined(SKYR_PERCENT_ENCODING_X86_DISPATCH)
+#  define SKYR_PERCENT_ENCODING_TARGET(isa) __attribute__((target(isa)))
+#else
+#  define SKYR_PERCENT_ENCODING_TARGET(isa)
+#endif
+
+/// \file byte_set.hpp
+/// Compiles each percent encode set into lookup tables, and provides kernels
+/// that classify or lowercase 16 or 32 bytes at a time with SSSE3, AVX2 or
+/// NEON.
+///
+/// With GCC and Clang on x86, the SSSE3 and AVX2 kernels are always
+/// compiled, and the fastest one that the CPU supports is chosen at run
+/// time, so no `-march` flag is needed. If the compiler targets AVX2,
+/// the AVX2 kernel is used without a check. Other compilers use the kernels
+/// enabled by their target flags, e.g. `/arch:AVX2`, and NEON is used on
+/// AArch64. Define `SKYR_PERCENT_ENCODING_NO_SIMD` to use the scalar
+/// kernels only.
+
+namespace skyr::percent_encoding {
+/// A set of bytes, stored as a lookup table for scalar code and as a
+/// pair of nibble tables for the vectorized kernels
+class byte_set {
+ public:
+  /// Constructs an empty set
+  constexpr byte_set() = default;
+
+  /// \param pred A predicate that returns `true` for the bytes in the set
+  /// \returns The set of bytes that satisfy the predicate
+  template <class Pred>
+  static constexpr auto from_predicate(Pred pred) -> byte_set {
+    auto result = byte_set{};
+    result.contains_non_ascii_ = true;
+    for (auto value = 0u; value < 256u; ++value) {
+      if (pred(std::byte(value))) {
+        result.table_[value] = 1;
+        if (value < 128u) {
+          result.low_nibbles_[value & 0x0fu] |= static_cast<std::uint8_t>(1u << (value >> 4));
+        }
+      } else if (value >= 128u) {
+        result.contains_non_ascii_ = false;
+      }
+    }
+    return result;
+  }
+
+  /// \param value A byte
+  /// \returns `true` if the byte is in the set
+  [[nodiscard]] constexpr auto contains(std::byte value) const noexcept -> bool {
+    return table_[std::to_integer<unsigned>(value)] != 0;
+  }
+
+  /// \param value A character
+  /// \returns `true` if the byte is in the set
+  [[nodiscard]] constexpr auto contains(char value) const noexcept -> bool {
+    return contains(std::byte(value));
+  }
+
+  /// \returns `true` if every byte from `0x80` to `0xff` is in the set,
+  ///          which the vectorized kernels require
+  [[nodiscard]] constexpr auto contains_non_ascii() const noexcept -> bool {
+    return contains_non_ascii_;
+  }
+
+  /// For each low nibble, the ASCII bytes in the set: bit `n` is set if
+  /// `(n << 4) | low` is in the set
+  /// \returns A table indexed by the low nibble of a byte
+  [[nodiscard]] constexpr auto low_nibbles() const noexcept -> const std::array<std::uint8_t, 16>& {
+    return low_nibbles_;
+  }
+
+ private:
+  std::array<std::uint8_t, 256> table_{};
+  std::array<std::uint8_t, 16> low_nibbles_{};
+  bool contains_non_ascii_ = false;
+};
+
+namespace details {
+inline constexpr auto c0_control_bytes = byte_set::from_predicate(is_c0_control_byte);
+inline constexpr auto fragment_bytes = byte_set::from_predicate(is_fragment_byte);
+inline constexpr auto query_bytes = byte_set::from_predicate(is_query_byte);
+inline constexpr auto special_query_bytes = byte_set::from_predicate(is_special_query_byte);
+inline constexpr auto path_bytes = byte_set::from_predicate(is_path_byte);
+inline constexpr auto userinfo_bytes = byte_set::from_predicate(is_userinfo_byte);
+inline constexpr auto component_bytes = byte_set::from_predicate(is_component_byte);
+inline constexpr auto form_urlencoded_bytes = byte_set::from_predicate(is_form_urlencoded_byte);
+inline constexpr auto all_bytes = byte_set::from_predicate([](std::byte) { return true; });
+}  // namespace details
+
+/// \param encodes An encode set
+/// \returns The bytes that are percent encoded by the encode set
+constexpr auto encode_set_bytes(encode_set encodes) noexcept -> const byte_set& {
+  switch (encodes) {
+    case encode_set::c0_control:
+      return details::c0_control_bytes;
+    case encode_set::fragment:
+      return details::fragment_bytes;
+    case encode_set::query:
+      return details::query_bytes;
+    case encode_set::special_query:
+      return details::special_query_bytes;
+    case encode_set::path:
+      return details::path_bytes;
+    case encode_set::userinfo:
+      return details::userinfo_bytes;
+    case encode_set::component:
+      return details::component_bytes;
+    case encode_set::form_urlencoded:
+      return details::form_urlencoded_bytes;
+    case encode_set::any:
+      break;
+  }
+  return details::all_bytes;
+}
+
+namespace details {
+/// \returns A pointer to the first byte in the set, or `last`
+constexpr auto scalar_find_first_of(const byte_set& bytes, const char* first, const char* last) noexcept
+    -> const char* {
+  while ((first != last) && !bytes.contains(*first)) {
+    ++first;
+  }
+  return first;
+}
+
+/// \returns The number of bytes in the set
+constexpr auto scalar_count(const byte_set& bytes, const char* first, const char* last) noexcept -> std::size_t {
+  auto count = std::size_t{0};
+  for (; first != last; ++first) {
+    count += bytes.contains(*first) ? 1 : 0;
+  }
+  return count;
+}
+
+/// \returns A pointer past the last byte written
+constexpr auto scalar_ascii_to_lower(const char* first, const char* last, char* out) noexcept -> char* {
+  for (; first != last; ++first, ++out) {
+    *out = ((*first >= 'A') && (*first <= 'Z')) ? static_cast<char>(*first + ('a' - 'A')) : *first;
+  }
+  return out;
+}
+
+/// \enum simd_kernel
+/// Enumerates the kernels that classify or lowercase several bytes at a time
+enum class simd_kernel {
+  /// One byte at a time
+  scalar,
+  /// 16 bytes at a time with SSSE3
+  ssse3,
+  /// 32 bytes at a time with AVX2
+  avx2,
+  /// 16 bytes at a time with AArch64 NEON
+  neon,
+};
+
+/// \param kernel A kernel
+/// \returns `true` if the kernel is compiled and the CPU supports it
+inline auto is_supported(simd_kernel kernel) noexcept -> bool {
+  switch (kernel) {
+    case simd_kernel::scalar:
+      return true;
+#if defined(SKYR_PERCENT_ENCODING_X86_DISPATCH)
+    case simd_kernel::ssse3:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("ssse3");
+    case simd_kernel::avx2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+#else
+#  if defined(SKYR_PERCENT_ENCODING_SSSE3)
+    case simd_kernel::ssse3:
+      return true;
+#  endif
+#  if defined(SKYR_PERCENT_ENCODING_AVX2)
+    case simd_kernel::avx2:
+      return true;
+#  endif
+#endif
+#if defined(SKYR_PERCENT_ENCODING_NEON)
+    case simd_kernel::neon:
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+/// \returns The fastest kernel that the CPU supports. Unless the compiler
+///          already targets AVX2, it is detected on the first call on x86.
+inline auto best_simd_kernel() noexcept -> simd_kernel {
+#if defined(SKYR_PERCENT_ENCODING_AVX2) && defined(__AVX2__)
+  return simd_kernel::avx2;
+#elif defined(SKYR_PERCENT_ENCODING_X86_DISPATCH)
+  static const auto kernel = is_supported(simd_kernel::avx2)    ? simd_kernel::avx2
+                             : is_supported(simd_kernel::ssse3) ? simd_kernel::ssse3
+                                                                : simd_kernel::scalar;
+  return kernel;
+#elif defined(SKYR_PERCENT_ENCODING_SSSE3)
+  return simd_kernel::ssse3;
+#elif defined(SKYR_PERCENT_ENCODING_NEON)
+  return simd_kernel::neon;
+#else
+  return simd_kernel::scalar;
+#endif
+}
+
+// Each block of bytes is classified with two table lookups: the low
+// nibble selects the ASCII bytes in the set with that low nibble, and
+// the high nibble selects one of them. Every non-ASCII byte is in the
+// set, so the sign bit of each byte is included directly.
+#if defined(SKYR_PERCENT_ENCODING_AVX2)
+/// \returns A bitmask with bit `n` set if byte `n` of the 32 byte block is in the set
+SKYR_PERCENT_ENCODING_TARGET("avx2")
+inline auto classify_block_avx2(const byte_set& bytes, const char* block) noexcept -> std::uint32_t {
+  auto low_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes.low_nibbles().data()));
+  auto lows = _mm256_broadcastsi128_si256(low_table);
+  auto highs = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128, 0,
+                                0, 0, 0, 0, 0, 0, 0);
+  auto nibble = _mm256_set1_epi8(0x0f);
+
+  auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  auto low = _mm256_shuffle_epi8(lows, _mm256_and_si256(input, nibble));
+  auto high = _mm256_shuffle_epi8(highs, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble));
+  auto ascii = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+  return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(ascii)) |
+         static_cast<std::uint32_t>(_mm256_movemask_epi8(input));
+}
+
+SKYR_PERCENT_ENCODING_TARGET("avx2")
+inline auto find_first_of_avx2(const byte_set& bytes, const char* first, const char* last) noexcept
+    -> const char* {
+  while ((last - first) >= 32) {
+    if (auto mask = classify_block_avx2(bytes, first); mask != 0) {
+      return first + std::countr_zero(mask);
+    }
+    first += 32;
+  }
+  return scalar_find_first_of(bytes, first, last);
+}
+
+SKYR_PERCENT_ENCODING_TARGET("avx2")
+inline auto count_avx2(const byte_set& bytes, const char* first, const char* last) noexcept -> std::size_t {
+  auto result = std::size_t{0};
+  while ((last - first) >= 32) {
+    result += static_cast<std::size_t>(std::popcount(classify_block_avx2(bytes, first)));
+    first += 32;
+  }
+  return result + scalar_count(bytes, first, last);
+}
+
+SKYR_PERCENT_ENCODING_TARGET("avx2")
+inline auto ascii_to_lower_avx2(const char* first, const char* last, char* out) noexcept -> char* {
+  // Bytes from 0x80 are negative, so are never in the range of uppercase letters
+  const auto before_upper = _mm256_set1_epi8('A' - 1), after_upper = _mm256_set1_epi8('Z' + 1);
+  const auto case_bit = _mm256_set1_epi8(0x20);
+  while ((last - first) >= 32) {
+    auto input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+    auto upper = _mm256_and_si256(_mm256_cmpgt_epi8(input, before_upper), _mm256_cmpgt_epi8(after_upper, input));
+    auto lower = _mm256_or_si256(input, _mm256_and_si256(upper, case_bit));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), lower);
+    first += 32;
+    out += 32;
+  }
+  return scalar_ascii_to_lower(first, last, out);
+}
+#endif  // defined(SKYR_PERCENT_ENCODING_AVX2)
+
+#if defined(SKYR_PERCENT_ENCODING_SSSE3)
+/// \returns A bitmask with bit `n` set if byte `n` of the 16 byte block is in the set
+SKYR_PERCENT_ENCODING_TARGET("ssse3")
+inline auto classify_block_ssse3(const byte_set& bytes, const char* block) noexcept -> std::uint32_t {
+  auto lows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes.low_nibbles().data()));
+  auto highs = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+  auto nibble = _mm_set1_epi8(0x0f);
+
+  auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+  auto low = _mm_shuffle_epi8(lows, _mm_and_si128(input, nibble));
+  auto high = _mm_shuffle_epi8(highs, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+  auto ascii = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+  auto in_set = ~static_cast<std::uint32_t>(_mm_movemask_epi8(ascii)) & 0xffffu;
+  return in_set | static_cast<std::uint32_t>(_mm_movemask_epi8(input));
+}
+
+SKYR_PERCENT_ENCODING_TARGET("ssse3")
+inline auto find_first_of_ssse3(const byte_set& bytes, const char* first, const char* last) noexcept
+    -> const char* {
+  while ((last - first) >= 16) {
+    if (auto mask = classify_block_ssse3(bytes, first); mask != 0) {
+      return first + std::countr_zero(mask);
+    }
+    first += 16;
+  }
+  return scalar_find_first_of(bytes, first, last);
+}
+
+SKYR_PERCENT_ENCODING_TARGET("ssse3")
+inline auto count_ssse3(const byte_set& bytes, const char* first, const char* last) noexcept -> std::size_t {
+  auto result = std::size_t{0};
+  while ((last - first) >= 16) {
+    result += static_cast<std::size_t>(std::popcount(classify_block_ssse3(bytes, first)));
+    first += 16;
+  }
+  return result + scalar_count(bytes, first, last);
+}
+
+SKYR_PERCENT_ENCODING_TARGET("ssse3")
+inline auto ascii_to_lower_ssse3(const char* first, const char* last, char* out) noexcept -> char* {
+  const auto before_upper = _mm_set1_epi8('A' - 1), after_upper = _mm_set1_epi8('Z' + 1);
+  const auto case_bit = _mm_set1_epi8(0x20);
+  while ((last - first) >= 16) {
+    auto input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+    auto upper = _mm_and_si128(_mm_cmpgt_epi8(input, before_upper), _mm_cmpgt_epi8(after_upper, input));
+    auto lower = _mm_or_si128(input, _mm_and_si128(upper, case_bit));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), lower);
+    first += 16;
+    out += 16;
+  }
+  return scalar_ascii_to_lower(first, last, out);
+}
+#endif  // defined(SKYR_PERCENT_ENCODING_SSSE3)
+
+#if defined(SKYR_PERCENT_ENCODING_NEON)
+/// \returns A bitmask with bit `n` set if byte `n` of the 16 byte block is in the set
+inline auto classify_block_neon(const byte_set& bytes, const char* block) noexcept -> std::uint32_t {
+  static constexpr std::uint8_t high_bits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 0, 0, 0, 0, 0, 0, 0, 0};
+  static constexpr std::uint8_t positions[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+  auto lows = vld1q_u8(bytes.low_nibbles().data());
+  auto highs = vld1q_u8(high_bits);
+  auto input = vld1q_u8(reinterpret_cast<const std::uint8_t*>(block));
+  auto low = vqtbl1q_u8(lows, vandq_u8(input, vdupq_n_u8(0x0f)));
+  auto high = vqtbl1q_u8(highs, vshrq_n_u8(input, 4));
+  auto in_set = vorrq_u8(vtstq_u8(low, high), vcgeq_u8(input, vdupq_n_u8(0x80)));
+
+  // Narrow the byte mask to one bit per byte
+  auto bits = vandq_u8(in_set, vld1q_u8(positions));
+  return static_cast<std::uint32_t>(vaddv_u8(vget_low_u8(bits))) |
+         (static_cast<std::uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+
+inline auto find_first_of_neon(const byte_set& bytes, const char* first, const char* last) noexcept
+    -> const char* {
+  while ((last - first) >= 16) {
+    if (auto mask = classify_block_neon(bytes, first); mask != 0) {
+      return first + std::countr_zero(mask);
+    }
+    first += 16;
+  }
+  return scalar_find_first_of(bytes, first, last);
+}
+
+inline auto count_neon(const byte_set& bytes, const char* first, const char* last) noexcept -> std::size_t {
+  auto result = std::size_t{0};
+  while ((last - first) >= 16) {
+    result += static_cast<std::size_t>(std::popcount(classify_block_neon(bytes, first)));
+    first += 16;
+  }
+  return result + scalar_count(bytes, first, last);
+}
+
+inline auto ascii_to_lower_neon(const char* first, const char* last, char* out) noexcept -> char* {
+  while ((last - first) >= 16) {
+    auto input = vld1q_u8(reinterpret_cast<const std::uint8_t*>(first));
+    auto upper = vandq_u8(vcgeq_u8(input, vdupq_n_u8('A')), vcleq_u8(input, vdupq_n_u8('Z')));
+    auto lower = vorrq_u8(input, vandq_u8(upper, vdupq_n_u8(0x20)));
+    vst1q_u8(reinterpret_cast<std::uint8_t*>(out), lower);
+    first += 16;
+    out += 16;
+  }
+  return scalar_ascii_to_lower(first, last, out);
+}
+#endif  // defined(SKYR_PERCENT_ENCODING_NEON)
+
+/// \param bytes A set of bytes, which must contain every non-ASCII byte
+///        to use a vectorized kernel
+/// \param kernel A kernel that `is_supported`
+/// \returns A pointer to the first byte in the set, or `last`
+inline auto find_first_of(const byte_set& bytes, const char* first, const char* last, simd_kernel kernel) noexcept
+    -> const char* {
+  if (bytes.contains_non_ascii()) {
+    switch (kernel) {
+#if defined(SKYR_PERCENT_ENCODING_AVX2)
+      case simd_kernel::avx2:
+        return find_first_of_avx2(bytes, first, last);
+#endif
+#if defined(SKYR_PERCENT_ENCODING_SSSE3)
+      case simd_kernel::ssse3:
+        return find_first_of_ssse3(bytes, first, last);
+#endif
+#if defined(SKYR_PERCENT_ENCODING_NEON)
+      case simd_kernel::neon:
+        return find_first_of_neon(bytes, first, last);
+#endif
+      default:
+        break;
+    }
+  }
+  return scalar_find_first_of(bytes, first, last);
+}
+
+/// \param bytes A set of bytes, which must contain every non-ASCII byte
+///        to use the vectorized kernel
+/// \returns A pointer to the first byte in the set, or `last`
+inline auto find_first_of(const byte_set& bytes, const char* first, const char* last) noexcept -> const char* {
+  return find_first_of(bytes, first, last, best_simd_kernel());
+}
+
+/// \param bytes A set of bytes, which must contain every non-ASCII byte
+///        to use a vectorized kernel
+/// \param kernel A kernel that `is_supported`
+/// \returns The number of bytes in the set
+inline auto count(const byte_set& bytes, const char* first, const char* last, simd_kernel kernel) noexcept
+    -> std::size_t {
+  if (bytes.contains_non_ascii()) {
+    switch (kernel) {
+#if defined(SKYR_PERCENT_ENCODING_AVX2)
+      case simd_kernel::avx2:
+        return count_avx2(bytes, first, last);
+#endif
+#if defined(SKYR_PERCENT_ENCODING_SSSE3)
+      case simd_kernel::ssse3:
+        return count_ssse3(bytes, first, last);
+#endif
+#if defined(SKYR_PERCENT_ENCODING_NEON)
+      case simd_kernel::neon:
+        return count_neon(bytes, first, last);
+#endif
+      default:
+        break;
+    }
+  }
+  return scalar_count(bytes, first, last);
+}
+
+/// \param bytes A set of bytes, which must contain every non-ASCII byte
+///        to use the vectorized kernel
+/// \returns The number of bytes in the set
+inline auto count(const byte_set& bytes, const char* first, const char* last) noexcept -> std::size_t {
+  return count(bytes, first, last, best_simd_kernel());
+}
+
+/// Copies ASCII bytes, converting `A` to `Z` to lowercase. Other bytes
+/// are copied unchanged.
+///
+/// \param out The output, which must have room for `last - first` bytes
+/// \param kernel A kernel that `is_supported`
+/// \returns A pointer past the last byte written
+inline auto ascii_to_lower(const char* first, const char* last, char* out, simd_kernel kernel) noexcept -> char* {
+  switch (kernel) {
+#if defined(SKYR_PERCENT_ENCODING_AVX2)
+    case simd_kernel::avx2:
+      return ascii_to_lower_avx2(first, last, out);
+#endif
+#if defined(SKYR_PERCENT_ENCODING_SSSE3)
+    case simd_kernel::ssse3:
+      return ascii_to_lower_ssse3(first, last, out);
+#endif
+#if defined(SKYR_PERCENT_ENCODING_NEON)
+    case simd_kernel::neon:
+      return ascii_to_lower_neon(first, last, out);
+#endif
+    default:
+      return scalar_ascii_to_lower(first, last, out);
+  }
+}
+
+/// Copies ASCII bytes, converting `A` to `Z` to lowercase. Other bytes
+/// are copied unchanged.
+///
+/// \param out The output, which must have room for `last - first` bytes
+/// \returns A pointer past the last byte written
+inline auto ascii_to_lower(const char* first, const char* last, char* out) noexcept -> char* {
+  return ascii_to_lower(first, last, out, best_simd_kernel());
+}
+}  // namespace details
+}  // namespace skyr::percent_encoding
+
+#endif  // SKYR_PERCENT_ENCODING_BYTE_SET_HPP
@@ -0,0 +1,197 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_PERCENT_ENCODING_DECODED_VIEW_HPP
+#define SKYR_PERCENT_ENCODING_DECODED_VIEW_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <utility>
+
+#include <skyr/percent_encoding/percent_decode.hpp>
+
+/// \file decoded_view.hpp
+/// Compares and iterates percent encoded strings as if they were decoded,
+/// without allocating a decoded copy
+
+namespace skyr {
+namespace percent_encoding {
+namespace details {
+/// Decodes the byte at the start of the input, which must start with a
+/// `%`. As in the WhatWG URL specification, a `%` that doesn't start a
+/// percent encoded byte is kept.
+///
+/// \returns The decoded byte and the number of input bytes it uses
+constexpr auto decode_escape(std::string_view input) noexcept -> std::pair<char, std::size_t> {
+  if (input.size() >= 3) {
+    auto high = hex_values[static_cast<unsigned char>(input[1])];
+    auto low = hex_values[static_cast<unsigned char>(input[2])];
+    if (((high | low) & 0xf0u) == 0) {
+      return {static_cast<char>((high << 4) | low), 3};
+    }
+  }
+  return {'%', 1};
+}
+
+/// Compares the decoded bytes of `encoded` with `decoded` until either
+/// runs out, and removes the bytes that were compared from each
+///
+/// \returns `false` at the first byte that differs
+constexpr auto consume_decoded(std::string_view& encoded, std::string_view& decoded) noexcept -> bool {
+  while (!encoded.empty() && !decoded.empty()) {
+    // Compare the run up to the next '%' at once
+    auto run = std::min({encoded.find('%'), encoded.size(), decoded.size()});
+    if (run != 0) {
+      if (encoded.substr(0, run) != decoded.substr(0, run)) {
+        return false;
+      }
+      encoded.remove_prefix(run);
+      decoded.remove_prefix(run);
+      continue;
+    }
+
+    auto [byte, size] = decode_escape(encoded);
+    if (byte != decoded.front()) {
+      return false;
+    }
+    encoded.remove_prefix(size);
+    decoded.remove_prefix(1);
+  }
+  return true;
+}
+}  // namespace details
+
+/// A view of a percent encoded string that decodes each byte as it is
+/// iterated.
+///
+/// As in the WhatWG URL specification, a `%` that doesn't start a
+/// percent encoded byte is kept, so iteration never fails.
+///
+/// ```
+/// auto view = skyr::percent_encoding::decoded_view("a%20b");
+/// assert(std::ranges::equal(view, std::string_view("a b")));
+/// ```
+class decoded_view : public std::ranges::view_interface<decoded_view> {
+ public:
+  /// A forward iterator over the decoded bytes
+  class iterator {
+   public:
+    ///
+    using iterator_category = std::forward_iterator_tag;
+    ///
+    using value_type = char;
+    ///
+    using difference_type = std::ptrdiff_t;
+    ///
+    using reference = char;
+
+    /// Constructor
+    constexpr iterator() = default;
+
+    /// \param remainder The encoded bytes that are left to decode
+    constexpr explicit iterator(std::string_view remainder) noexcept : remainder_(remainder) {
+    }
+
+    /// \returns The decoded byte
+    [[nodiscard]] constexpr auto operator*() const noexcept -> char {
+      return (remainder_.front() == '%') ? details::decode_escape(remainder_).first : remainder_.front();
+    }
+
+    ///
+    constexpr auto operator++() noexcept -> iterator& {
+      auto size = (remainder_.front() == '%') ? details::decode_escape(remainder_).second : 1;
+      remainder_.remove_prefix(size);
+      return *this;
+    }
+
+    ///
+    constexpr auto operator++(int) noexcept -> iterator {
+      auto result = *this;
+      ++*this;
+      return result;
+    }
+
+    /// Iterators are equal if they refer to the same position in the
+    /// encoded string
+    [[nodiscard]] constexpr auto operator==(const iterator& other) const noexcept -> bool {
+      return remainder_.data() == other.remainder_.data();
+    }
+
+   private:
+    std::string_view remainder_;
+  };
+
+  /// Constructor
+  constexpr decoded_view() = default;
+
+  /// \param encoded A percent encoded string
+  constexpr explicit decoded_view(std::string_view encoded) noexcept : encoded_(encoded) {
+  }
+
+  /// \returns An iterator to the first decoded byte
+  [[nodiscard]] constexpr auto begin() const noexcept -> iterator {
+    return iterator(encoded_);
+  }
+
+  /// \returns An iterator past the last decoded byte
+  [[nodiscard]] constexpr auto end() const noexcept -> iterator {
+    return iterator(encoded_.substr(encoded_.size()));
+  }
+
+  /// \returns The percent encoded string
+  [[nodiscard]] constexpr auto encoded() const noexcept -> std::string_view {
+    return encoded_;
+  }
+
+  /// \param decoded A decoded string
+  /// \returns `true` if this view decodes to `decoded`
+  [[nodiscard]] constexpr auto equals(std::string_view decoded) const noexcept -> bool {
+    auto encoded = encoded_;
+    return details::consume_decoded(encoded, decoded) && encoded.empty() && decoded.empty();
+  }
+
+  /// \param prefix A decoded prefix
+  /// \returns `true` if this view decodes to a string that starts with
+  ///          `prefix`
+  [[nodiscard]] constexpr auto starts_with(std::string_view prefix) const noexcept -> bool {
+    auto encoded = encoded_;
+    return details::consume_decoded(encoded, prefix) && prefix.empty();
+  }
+
+ private:
+  std::string_view encoded_;
+};
+}  // namespace percent_encoding
+
+/// Compares a percent encoded string with a decoded string, byte by
+/// byte, stopping at the first difference
+///
+/// ```
+/// assert(skyr::decoded_equals("/caf%C3%A9", "/café"));
+/// ```
+///
+/// \param encoded A percent encoded string
+/// \param decoded A decoded string
+/// \returns `true` if `encoded` decodes to `decoded`
+constexpr auto decoded_equals(std::string_view encoded, std::string_view decoded) noexcept -> bool {
+  return percent_encoding::decoded_view(encoded).equals(decoded);
+}
+
+/// Tests if a percent encoded string decodes to a string that starts
+/// with a prefix, stopping at the first difference
+///
+/// \param encoded A percent encoded string
+/// \param prefix A decoded prefix
+/// \returns `true` if `encoded` decodes to a string that starts with
+///          `prefix`
+constexpr auto decoded_starts_with(std::string_view encoded, std::string_view prefix) noexcept -> bool {
+  return percent_encoding::decoded_view(encoded).starts_with(prefix);
+}
+}  // namespace skyr
+
+#endif  // SKYR_PERCENT_ENCODING_DECODED_VIEW_HPP
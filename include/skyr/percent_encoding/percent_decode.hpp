@@ -6,26 +6,202 @@
 #ifndef SKYR_PERCENT_DECODING_PERCENT_DECODE_HPP
 #define SKYR_PERCENT_DECODING_PERCENT_DECODE_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <expected>
+#include <span>
+#include <string>
 #include <string_view>
 
 #include <skyr/percent_encoding/errors.hpp>
 #include <skyr/percent_encoding/percent_decode_range.hpp>
 
 namespace skyr {
+namespace percent_encoding::details {
+/// The value of each hexadecimal digit, or `0xff` for any other character
+inline constexpr auto hex_values = [] {
+  auto values = std::array<std::uint8_t, 256>{};
+  values.fill(0xff);
+  for (auto digit = 0u; digit < 10u; ++digit) {
+    values['0' + digit] = static_cast<std::uint8_t>(digit);
+  }
+  for (auto digit = 0u; digit < 6u; ++digit) {
+    values['a' + digit] = static_cast<std::uint8_t>(10u + digit);
+    values['A' + digit] = static_cast<std::uint8_t>(10u + digit);
+  }
+  return values;
+}();
+
+/// Copies a run of bytes that may overlap the output, which is the case
+/// when decoding in place
+///
+/// \param out The output, which is never after `first`
+/// \param first The first byte of the run
+/// \param last The end of the run
+/// \returns A pointer past the last byte written
+inline auto move_run(char* out, const char* first, const char* last) noexcept -> char* {
+  auto size = static_cast<std::size_t>(last - first);
+  if ((out != first) && (size != 0)) {
+    std::memmove(out, first, size);
+  }
+  return out + size;
+}
+
+/// Percent decodes the input, copying the runs of bytes between each
+/// `%` at once
+///
+/// \param out The output, which must have room for `input.size()` bytes.
+///        It may be `input.data()`, as the output never overtakes the
+///        input.
+/// \param input The input
+/// \returns A pointer past the last byte written, or an error
+inline auto percent_decode_to(char* out, std::string_view input) noexcept
+    -> std::expected<char*, percent_encode_errc> {
+  auto first = input.data(), last = input.data() + input.size();
+  while (first != last) {
+    auto percent = static_cast<const char*>(std::memchr(first, '%', static_cast<std::size_t>(last - first)));
+    if (percent == nullptr) {
+      return move_run(out, first, last);
+    }
+
+    out = move_run(out, first, percent);
+    if ((last - percent) < 3) {
+      return std::unexpected(percent_encode_errc::overflow);
+    }
+
+    auto high = hex_values[static_cast<unsigned char>(percent[1])];
+    auto low = hex_values[static_cast<unsigned char>(percent[2])];
+    if (((high | low) & 0xf0u) != 0) {
+      return std::unexpected(percent_encode_errc::non_hex_input);
+    }
+    *out++ = static_cast<char>((high << 4) | low);
+    first = percent + 3;
+  }
+  return out;
+}
+
+/// Percent decodes the input as the WhatWG URL specification does,
+/// keeping each `%` that doesn't start a percent encoded byte
+///
+/// \param out The output, which must have room for `input.size()` bytes.
+///        It may be `input.data()`.
+/// \param input The input
+/// \returns A pointer past the last byte written
+inline auto percent_decode_lenient_to(char* out, std::string_view input) noexcept -> char* {
+  auto first = input.data(), last = input.data() + input.size();
+  while (first != last) {
+    auto percent = static_cast<const char*>(std::memchr(first, '%', static_cast<std::size_t>(last - first)));
+    if (percent == nullptr) {
+      return move_run(out, first, last);
+    }
+
+    out = move_run(out, first, percent);
+    if ((last - percent) >= 3) {
+      auto high = hex_values[static_cast<unsigned char>(percent[1])];
+      auto low = hex_values[static_cast<unsigned char>(percent[2])];
+      if (((high | low) & 0xf0u) == 0) {
+        *out++ = static_cast<char>((high << 4) | low);
+        first = percent + 3;
+        continue;
+      }
+    }
+    *out++ = '%';
+    first = percent + 1;
+  }
+  return out;
+}
+}  // namespace percent_encoding::details
+
+/// \param input The input
+/// \returns `true` if the input contains a `%`, and so may need to be
+///          percent decoded
+inline auto has_percent_encoding(std::string_view input) noexcept -> bool {
+  return !input.empty() && (std::memchr(input.data(), '%', input.size()) != nullptr);
+}
+
 /// Percent decodes the input
 /// \returns The percent decoded output when successful, an error otherwise.
 inline auto percent_decode(std::string_view input)
     -> std::expected<std::string, percent_encoding::percent_encode_errc> {
-  auto result = std::string{};
-  for (auto&& value : percent_encoding::percent_decode_range{input}) {
-    if (!value) {
-      return std::unexpected((value).error());
-    }
-    result.push_back((value).value());
+  if (!has_percent_encoding(input)) {
+    return std::string(input);
+  }
+
+  // Decoding never makes the output larger than the input
+  auto result = std::string(input.size(), '\0');
+  auto last = percent_encoding::details::percent_decode_to(result.data(), input);
+  if (!last) {
+    return std::unexpected(last.error());
   }
+  result.resize(static_cast<std::size_t>(last.value() - result.data()));
   return result;
 }
+
+/// Percent decodes a buffer in place. Decoding never makes the output
+/// larger than the input, so no memory is allocated.
+///
+/// ```
+/// char buffer[] = {'a', '%', '2', '0', 'b'};
+/// auto size = skyr::percent_decode_in_place(buffer);
+/// assert(std::string_view(buffer, size.value()) == "a b");
+/// ```
+///
+/// \param buffer The percent encoded bytes
+/// \returns The number of decoded bytes, which are at the start of the
+///          buffer, or an error, in which case the contents of the buffer
+///          are unspecified
+inline auto percent_decode_in_place(std::span<char> buffer) noexcept
+    -> std::expected<std::size_t, percent_encoding::percent_encode_errc> {
+  auto input = std::string_view(buffer.data(), buffer.size());
+  if (!has_percent_encoding(input)) {
+    return buffer.size();
+  }
+
+  auto last = percent_encoding::details::percent_decode_to(buffer.data(), input);
+  if (!last) {
+    return std::unexpected(last.error());
+  }
+  return static_cast<std::size_t>(last.value() - buffer.data());
+}
+
+/// Percent decodes a string in place, and resizes it to the decoded
+/// bytes
+///
+/// \param buffer The percent encoded string
+/// \returns The size of the decoded string, or an error, in which case
+///          the contents of the string are unspecified
+inline auto percent_decode_in_place(std::string& buffer) noexcept
+    -> std::expected<std::size_t, percent_encoding::percent_encode_errc> {
+  auto size = percent_decode_in_place(std::span<char>(buffer));
+  if (size) {
+    buffer.resize(size.value());
+  }
+  return size;
+}
+
+/// Percent decodes the input, only when it contains a `%`
+///
+/// \param input The input
+/// \param buffer A buffer that is used when the input needs decoding,
+///        so that it can be reused for several inputs
+/// \returns The input itself if it contains no `%`, otherwise a view of
+///          the decoded input in `buffer`, or an error
+inline auto percent_decode_view(std::string_view input, std::string& buffer)
+    -> std::expected<std::string_view, percent_encoding::percent_encode_errc> {
+  if (!has_percent_encoding(input)) {
+    return input;
+  }
+
+  buffer.resize(input.size());
+  auto last = percent_encoding::details::percent_decode_to(buffer.data(), input);
+  if (!last) {
+    return std::unexpected(last.error());
+  }
+  buffer.resize(static_cast<std::size_t>(last.value() - buffer.data()));
+  return std::string_view(buffer);
+}
 }  // namespace skyr
 
 #endif  // SKYR_PERCENT_DECODING_PERCENT_DECODE_HPP
@@ -7,6 +7,7 @@
 #define SKYR_PERCENT_ENCODING_PERCENT_DECODE_RANGE_HPP
 
 #include <cassert>
+#include <cstddef>
 #include <expected>
 #include <iterator>
 #include <string_view>
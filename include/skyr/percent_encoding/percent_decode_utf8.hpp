@@ -0,0 +1,181 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_PERCENT_ENCODING_PERCENT_DECODE_UTF8_HPP
+#define SKYR_PERCENT_ENCODING_PERCENT_DECODE_UTF8_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <skyr/percent_encoding/byte_set.hpp>
+#include <skyr/percent_encoding/decoded_view.hpp>
+#include <skyr/unicode/errors.hpp>
+
+/// \file percent_decode_utf8.hpp
+/// Percent decodes a string and checks that the decoded bytes are valid
+/// UTF-8 in the same pass, for displaying URL components
+
+namespace skyr {
+/// \enum invalid_utf8
+/// Enumerates how invalid UTF-8 is handled when decoding
+enum class invalid_utf8 {
+  /// Decoding fails
+  fail,
+  /// Each invalid sequence is replaced with U+FFFD
+  replace,
+};
+
+/// The result of `percent_decode_utf8_to`
+template <class OutputIt>
+struct percent_decode_utf8_result {
+  /// The output iterator, after the last byte written
+  OutputIt out;
+  /// The number of code points written
+  std::size_t code_points;
+};
+
+namespace percent_encoding::details {
+/// The bytes that end a run that can be copied without being decoded or
+/// validated
+inline constexpr auto utf8_run_end_bytes = byte_set::from_predicate(
+    [](std::byte byte) { return (byte == std::byte('%')) || (std::to_integer<unsigned>(byte) >= 0x80u); });
+
+/// The bytes from `0x80` to `0xff`
+inline constexpr auto non_ascii_bytes =
+    byte_set::from_predicate([](std::byte byte) { return std::to_integer<unsigned>(byte) >= 0x80u; });
+}  // namespace percent_encoding::details
+
+/// Percent decodes the input and checks that the decoded bytes are valid
+/// UTF-8 in a single pass.
+///
+/// As in the WhatWG URL specification, a `%` that doesn't start a
+/// percent encoded byte is kept, and invalid sequences are found as the
+/// [UTF-8 decoder](https://encoding.spec.whatwg.org/#utf-8-decoder)
+/// does. Runs of ASCII bytes are found and copied with the vectorized
+/// kernels when they are enabled.
+///
+/// \param out An output iterator
+/// \param input A percent encoded string
+/// \param errors How invalid UTF-8 is handled
+/// \returns The output iterator and the number of code points written,
+///          or an error if `errors` is `invalid_utf8::fail` and the
+///          decoded bytes are not valid UTF-8
+template <std::output_iterator<char> OutputIt>
+auto percent_decode_utf8_to(OutputIt out, std::string_view input, invalid_utf8 errors = invalid_utf8::replace)
+    -> std::expected<percent_decode_utf8_result<OutputIt>, unicode::unicode_errc> {
+  using namespace std::string_view_literals;
+
+  const auto& run_end = percent_encoding::details::utf8_run_end_bytes;
+  auto code_points = std::size_t{0};
+
+  // Decodes the byte at `first`, which may be percent encoded
+  auto decode = [](const char* first, const char* last) {
+    return (*first == '%') ? percent_encoding::details::decode_escape(std::string_view(first, last))
+                           : std::pair<char, std::size_t>{*first, 1};
+  };
+
+  auto first = input.data(), last = input.data() + input.size();
+  while (first != last) {
+    auto special = percent_encoding::details::find_first_of(run_end, first, last);
+    code_points += static_cast<std::size_t>(special - first);
+    out = std::ranges::copy(first, special, std::move(out)).out;
+    first = special;
+    if (first == last) {
+      break;
+    }
+
+    auto [lead, lead_size] = decode(first, last);
+    auto value = static_cast<unsigned char>(lead);
+    first += lead_size;
+
+    // The number of continuation bytes, and the bounds of the first one
+    auto needed = 0u;
+    auto lower = 0x80u, upper = 0xbfu;
+    if (value < 0x80u) {
+      *out++ = lead;
+      ++code_points;
+      continue;
+    } else if ((value >= 0xc2u) && (value <= 0xdfu)) {
+      needed = 1;
+    } else if ((value >= 0xe0u) && (value <= 0xefu)) {
+      lower = (value == 0xe0u) ? 0xa0u : 0x80u;
+      upper = (value == 0xedu) ? 0x9fu : 0xbfu;
+      needed = 2;
+    } else if ((value >= 0xf0u) && (value <= 0xf4u)) {
+      lower = (value == 0xf0u) ? 0x90u : 0x80u;
+      upper = (value == 0xf4u) ? 0x8fu : 0xbfu;
+      needed = 3;
+    } else if (errors == invalid_utf8::fail) {
+      return std::unexpected(unicode::unicode_errc::invalid_lead);
+    }
+
+    auto sequence = std::array<char, 4>{lead};
+    auto sequence_size = 1u;
+    while ((sequence_size <= needed) && (first != last)) {
+      auto [byte, size] = decode(first, last);
+      auto continuation = static_cast<unsigned char>(byte);
+      if ((continuation < lower) || (continuation > upper)) {
+        // The byte isn't consumed, and is decoded again as the start of
+        // the next sequence
+        if (errors == invalid_utf8::fail) {
+          return std::unexpected(unicode::unicode_errc::illegal_byte_sequence);
+        }
+        break;
+      }
+      sequence[sequence_size++] = byte;
+      first += size;
+      lower = 0x80u;
+      upper = 0xbfu;
+    }
+
+    if ((needed != 0) && (sequence_size == needed + 1)) {
+      out = std::ranges::copy(sequence.data(), sequence.data() + sequence_size, std::move(out)).out;
+    } else if ((errors == invalid_utf8::fail) && (needed != 0)) {
+      return std::unexpected(unicode::unicode_errc::overflow);
+    } else {
+      out = std::ranges::copy("\xef\xbf\xbd"sv, std::move(out)).out;
+    }
+    ++code_points;
+  }
+  return percent_decode_utf8_result<OutputIt>{std::move(out), code_points};
+}
+
+/// Percent decodes the input and checks that the decoded bytes are valid
+/// UTF-8 in a single pass
+///
+/// ```
+/// assert(skyr::percent_decode_utf8("caf%C3%A9").value() == "café");
+/// assert(skyr::percent_decode_utf8("%FFa").value() == "\xef\xbf\xbd" "a");
+/// assert(!skyr::percent_decode_utf8("%FFa", skyr::invalid_utf8::fail));
+/// ```
+///
+/// \param input A percent encoded string
+/// \param errors How invalid UTF-8 is handled
+/// \returns The decoded string, or an error if `errors` is
+///          `invalid_utf8::fail` and the decoded bytes are not valid UTF-8
+inline auto percent_decode_utf8(std::string_view input, invalid_utf8 errors = invalid_utf8::replace)
+    -> std::expected<std::string, unicode::unicode_errc> {
+  // Each percent encoded byte is decoded to at most three bytes, and
+  // only a non-ASCII byte that isn't percent encoded can grow, when it is
+  // replaced with U+FFFD
+  const auto& non_ascii = percent_encoding::details::non_ascii_bytes;
+  auto first = input.data(), last = input.data() + input.size();
+  auto result = std::string(input.size() + (2 * percent_encoding::details::count(non_ascii, first, last)), '\0');
+  auto decoded = percent_decode_utf8_to(result.data(), input, errors);
+  if (!decoded) {
+    return std::unexpected(decoded.error());
+  }
+  result.resize(static_cast<std::size_t>(decoded.value().out - result.data()));
+  return result;
+}
+}  // namespace skyr
+
+#endif  // SKYR_PERCENT_ENCODING_PERCENT_DECODE_UTF8_HPP
@@ -6,32 +6,75 @@
 #ifndef SKYR_PERCENT_ENCODING_PERCENT_ENCODE_HPP
 #define SKYR_PERCENT_ENCODING_PERCENT_ENCODE_HPP
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <utility>
 
+#include <skyr/percent_encoding/byte_set.hpp>
 #include <skyr/percent_encoding/percent_encoded_char.hpp>
 
 namespace skyr {
+namespace percent_encoding::details {
+/// Percent encodes the bytes in a set, copying runs of other bytes at once
+template <std::output_iterator<char> OutputIt>
+auto percent_encode_to(OutputIt out, std::string_view input, const byte_set& bytes) -> OutputIt {
+  auto first = input.data(), last = input.data() + input.size();
+  while (first != last) {
+    auto encoded = find_first_of(bytes, first, last);
+    out = std::ranges::copy(first, encoded, out).out;
+    if (encoded == last) {
+      break;
+    }
+
+    auto byte = std::byte(*encoded);
+    *out++ = '%';
+    *out++ = hex_to_alnum((byte >> 4) & std::byte(0x0f));
+    *out++ = hex_to_alnum(byte & std::byte(0x0f));
+    first = std::next(encoded);
+  }
+  return out;
+}
+
+/// \returns The size of the input when the bytes in a set are percent encoded
+inline auto percent_encoded_size(std::string_view input, const byte_set& bytes) noexcept -> std::size_t {
+  return input.size() + (2 * count(bytes, input.data(), input.data() + input.size()));
+}
+}  // namespace percent_encoding::details
+
 /// Percent encodes the input
 /// \returns The percent encoded output when successful, an error otherwise.
 inline auto percent_encode_bytes(std::string_view input, percent_encoding::encode_set encodes) -> std::string {
-  auto encode = [encodes](auto byte) {
-    using percent_encoding::percent_encode_byte;
-    return percent_encode_byte(std::byte(byte), encodes);
-  };
-
-  auto result = std::string{};
-  result.reserve(input.size() * 3);  // Worst case: each byte becomes "%XX"
-  for (const auto& encoded : input | std::ranges::views::transform(encode)) {
-    result.append(encoded.begin(), encoded.end());
-  }
+  const auto& bytes = percent_encoding::encode_set_bytes(encodes);
+  auto result = std::string(percent_encoding::details::percent_encoded_size(input, bytes), '\0');
+  percent_encoding::details::percent_encode_to(result.data(), input, bytes);
   return result;
 }
 
 inline auto percent_encode(std::string_view input) -> std::string {
   return percent_encode_bytes(input, percent_encoding::encode_set::component);
 }
+
+/// Percent encodes the input with the component percent encode set,
+/// writing to an output iterator
+/// \param out An output iterator
+/// \param input The bytes to encode
+/// \returns The output iterator, after the last character written
+template <std::output_iterator<char> OutputIt>
+auto percent_encode_to(OutputIt out, std::string_view input) -> OutputIt {
+  using percent_encoding::details::component_bytes;
+  return percent_encoding::details::percent_encode_to(std::move(out), input, component_bytes);
+}
+
+/// \param input The bytes to encode
+/// \returns The size of the input when it is percent encoded with the
+///          component percent encode set
+inline auto percent_encoded_size(std::string_view input) noexcept -> std::size_t {
+  return percent_encoding::details::percent_encoded_size(input, percent_encoding::details::component_bytes);
+}
 }  // namespace skyr
 
 #endif  // SKYR_PERCENT_ENCODING_PERCENT_ENCODE_HPP
@@ -83,6 +83,14 @@ inline constexpr auto is_component_byte(std::byte value) {
   return is_userinfo_byte(value) || (value == std::byte(0x24)) || (value == std::byte(0x25)) ||
          (value == std::byte(0x26)) || (value == std::byte(0x2b)) || (value == std::byte(0x2c));
 }
+
+///
+/// \param value
+/// \return
+inline constexpr auto is_form_urlencoded_byte(std::byte value) {
+  return is_component_byte(value) || (value == std::byte(0x21)) || (value == std::byte(0x27)) ||
+         (value == std::byte(0x28)) || (value == std::byte(0x29)) || (value == std::byte(0x7e));
+}
 }  // namespace details
 
 ///
@@ -103,6 +111,8 @@ enum class encode_set {
   userinfo,
   ///
   component,
+  ///
+  form_urlencoded,
 };
 
 ///
@@ -225,6 +235,8 @@ inline auto percent_encode_byte(std::byte value, encode_set encodes) -> percent_
       return percent_encode_byte(value, details::is_query_byte);
     case encode_set::fragment:
       return percent_encode_byte(value, details::is_fragment_byte);
+    case encode_set::form_urlencoded:
+      return percent_encode_byte(value, details::is_form_urlencoded_byte);
   }
   return percent_encoding::percent_encoded_char(value);
 }
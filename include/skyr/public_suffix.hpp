@@ -0,0 +1,12 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_PUBLIC_SUFFIX_HPP
+#define SKYR_PUBLIC_SUFFIX_HPP
+
+#include <skyr/public_suffix/errors.hpp>
+#include <skyr/public_suffix/public_suffix_list.hpp>
+
+#endif  // SKYR_PUBLIC_SUFFIX_HPP
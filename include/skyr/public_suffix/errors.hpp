@@ -0,0 +1,23 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_PUBLIC_SUFFIX_ERRORS_HPP
+#define SKYR_PUBLIC_SUFFIX_ERRORS_HPP
+
+namespace skyr {
+/// \enum public_suffix_errc
+/// Enumerates errors when loading and compiling a public suffix list
+enum class public_suffix_errc {
+  /// The list file can't be opened or read
+  cannot_open_file = 1,
+  /// A rule is not a valid domain, or has a wildcard that isn't its first
+  /// label
+  invalid_rule,
+  /// The compiled list doesn't fit in the table format
+  too_large,
+};
+}  // namespace skyr
+
+#endif  // SKYR_PUBLIC_SUFFIX_ERRORS_HPP
@@ -0,0 +1,530 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_PUBLIC_SUFFIX_PUBLIC_SUFFIX_LIST_HPP
+#define SKYR_PUBLIC_SUFFIX_PUBLIC_SUFFIX_LIST_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <skyr/domain/domain.hpp>
+#include <skyr/public_suffix/errors.hpp>
+
+/// \file public_suffix_list.hpp
+/// A compiled [Public Suffix List](https://publicsuffix.org/), used to find
+/// the public suffix and registrable domain of a host
+
+namespace skyr {
+/// A state in a compiled public suffix list.
+///
+/// Its outgoing edges are `edge_count` consecutive entries of the edge
+/// table, starting at `first_edge`.
+struct public_suffix_node {
+  std::uint32_t first_edge;
+  std::uint16_t edge_count;
+  std::uint8_t flags;
+};
+
+/// A transition in a compiled public suffix list, labelled with one
+/// (lowercase, ASCII) domain label from the label pool
+struct public_suffix_edge {
+  std::uint32_t label_offset : 24;
+  std::uint32_t label_length : 8;
+  std::uint32_t node;
+};
+
+namespace public_suffix_flags {
+/// The labels leading to the node are a rule
+constexpr std::uint8_t rule = 0x01;
+/// Any label below the node is a rule (e.g. `*.kobe.jp`)
+constexpr std::uint8_t wildcard = 0x02;
+/// The labels leading to the node are an exception to a wildcard
+/// (e.g. `!city.kobe.jp`)
+constexpr std::uint8_t exception = 0x04;
+/// The same flags, for rules in the private section of the list, are
+/// shifted left by this amount
+constexpr std::uint8_t private_shift = 3;
+}  // namespace public_suffix_flags
+
+namespace details {
+/// Marks an empty slot in the hash table of edges
+constexpr auto public_suffix_no_edge = std::uint32_t{0xffffffff};
+
+/// Hashes a transition from a node, using FNV-1a over the label
+///
+/// \param node The index of the node
+/// \param label The label of the transition
+/// \returns A hash value
+constexpr auto public_suffix_hash(std::uint32_t node, std::string_view label) noexcept -> std::uint32_t {
+  auto hash = 0x811c9dc5u ^ (node * 0x9e3779b1u);
+  for (auto byte : label) {
+    hash = (hash ^ static_cast<unsigned char>(byte)) * 0x01000193u;
+  }
+  return hash;
+}
+
+struct public_suffix_storage {
+  std::vector<public_suffix_node> nodes;
+  std::vector<public_suffix_edge> edges;
+  std::string labels;
+  std::vector<std::uint32_t> index;
+};
+
+/// Builds a trie of rules, keyed on their labels from right to left, and
+/// minimizes it into a DAFSA by merging identical sub-tries
+class public_suffix_builder {
+ public:
+  auto insert(std::string_view rule, bool is_private) -> std::expected<void, public_suffix_errc> {
+    using namespace public_suffix_flags;
+
+    std::uint8_t flag = public_suffix_flags::rule;
+    if (rule.starts_with('!')) {
+      flag = exception;
+      rule.remove_prefix(1);
+    }
+    if (rule == "*") {
+      // The implicit default rule
+      return {};
+    }
+    if (rule.starts_with("*.")) {
+      if (flag == exception) {
+        return std::unexpected(public_suffix_errc::invalid_rule);
+      }
+      flag = wildcard;
+      rule.remove_prefix(2);
+    }
+    if (rule.empty()) {
+      return std::unexpected(public_suffix_errc::invalid_rule);
+    }
+
+    auto node = std::size_t{0};
+    auto end = rule.size();
+    auto label = std::string{};
+    while (true) {
+      auto dot = rule.rfind('.', end - 1);
+      auto first = (dot == std::string_view::npos) ? 0 : dot + 1;
+      auto normalized = normalize_label(rule.substr(first, end - first), &label);
+      if (!normalized) {
+        return std::unexpected(normalized.error());
+      }
+
+      auto child = trie_[node].children.find(label);
+      if (child == trie_[node].children.end()) {
+        trie_[node].children.emplace(label, trie_.size());
+        node = trie_.size();
+        trie_.emplace_back();
+      } else {
+        node = child->second;
+      }
+
+      if (first == 0) {
+        break;
+      }
+      end = dot;
+    }
+
+    trie_[node].flags |= is_private ? static_cast<std::uint8_t>(flag << private_shift) : flag;
+    return {};
+  }
+
+  auto build() -> std::expected<public_suffix_storage, public_suffix_errc> {
+    auto storage = public_suffix_storage{};
+    auto unique_nodes = std::unordered_map<std::string, std::uint32_t>{};
+    auto label_offsets = std::unordered_map<std::string_view, std::uint32_t>{};
+    auto result = intern(0, &storage, &unique_nodes, &label_offsets);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+
+    // Nodes are interned after their children, so the root is the last one. Reverse them so that the root is
+    // first, and a lookup walks towards the end of the table.
+    auto last = static_cast<std::uint32_t>(storage.nodes.size() - 1);
+    std::ranges::reverse(storage.nodes);
+    for (auto& edge : storage.edges) {
+      edge.node = last - edge.node;
+    }
+
+    // An open addressing hash table of the edges, so that a lookup doesn't need a binary search of the hundreds of
+    // top level domains. An edge belongs to the node whose range of edges contains it.
+    storage.index.assign(std::bit_ceil(storage.edges.size() + storage.edges.size() / 4 + 1), public_suffix_no_edge);
+    auto mask = storage.index.size() - 1;
+    for (auto node = std::uint32_t{0}; node < storage.nodes.size(); ++node) {
+      auto first_edge = storage.nodes[node].first_edge;
+      for (auto edge = first_edge; edge < first_edge + storage.nodes[node].edge_count; ++edge) {
+        auto label = std::string_view(storage.labels).substr(storage.edges[edge].label_offset,
+                                                             storage.edges[edge].label_length);
+        auto slot = public_suffix_hash(node, label) & mask;
+        while (storage.index[slot] != public_suffix_no_edge) {
+          slot = (slot + 1) & mask;
+        }
+        storage.index[slot] = edge;
+      }
+    }
+    return storage;
+  }
+
+ private:
+  struct trie_node {
+    std::map<std::string, std::size_t, std::less<>> children;
+    std::uint8_t flags = 0;
+  };
+
+  static auto normalize_label(std::string_view label, std::string* normalized)
+      -> std::expected<void, public_suffix_errc> {
+    normalized->clear();
+    if (label.empty() || label.contains('*')) {
+      return std::unexpected(public_suffix_errc::invalid_rule);
+    }
+
+    if (std::ranges::all_of(label, [](auto byte) { return static_cast<unsigned char>(byte) < 0x80; })) {
+      std::ranges::transform(label, std::back_inserter(*normalized), [](auto byte) {
+        return ((byte >= 'A') && (byte <= 'Z')) ? static_cast<char>(byte + ('a' - 'A')) : byte;
+      });
+    } else if (!domain_to_ascii(label, normalized)) {
+      return std::unexpected(public_suffix_errc::invalid_rule);
+    }
+
+    if (normalized->empty() || normalized->contains('.') || (normalized->size() > 0xff)) {
+      return std::unexpected(public_suffix_errc::invalid_rule);
+    }
+    return {};
+  }
+
+  auto intern(std::size_t index, public_suffix_storage* storage,
+              std::unordered_map<std::string, std::uint32_t>* unique_nodes,
+              std::unordered_map<std::string_view, std::uint32_t>* label_offsets)
+      -> std::expected<std::uint32_t, public_suffix_errc> {
+    const auto& node = trie_[index];
+    if (node.children.size() > 0xffff) {
+      return std::unexpected(public_suffix_errc::too_large);
+    }
+
+    // Two nodes can be merged if they have the same flags, and the same labels leading to the same (merged) children
+    auto key = std::string(1, static_cast<char>(node.flags));
+    auto children = std::vector<std::uint32_t>{};
+    for (const auto& [label, child] : node.children) {
+      auto interned = intern(child, storage, unique_nodes, label_offsets);
+      if (!interned) {
+        return interned;
+      }
+      children.push_back(interned.value());
+      key += label;
+      key += '\0';
+      key.append(reinterpret_cast<const char*>(&children.back()), sizeof(std::uint32_t));
+    }
+
+    auto existing = unique_nodes->find(key);
+    if (existing != unique_nodes->end()) {
+      return existing->second;
+    }
+
+    auto first_edge = static_cast<std::uint32_t>(storage->edges.size());
+    auto child = children.begin();
+    for (const auto& [label, _] : node.children) {
+      auto offset = label_offsets->find(label);
+      if (offset == label_offsets->end()) {
+        if (storage->labels.size() + label.size() > 0xffffff) {
+          return std::unexpected(public_suffix_errc::too_large);
+        }
+        offset = label_offsets->emplace(label, static_cast<std::uint32_t>(storage->labels.size())).first;
+        storage->labels += label;
+      }
+      storage->edges.push_back({offset->second, static_cast<std::uint32_t>(label.size()), *child++});
+    }
+
+    auto id = static_cast<std::uint32_t>(storage->nodes.size());
+    storage->nodes.push_back({first_edge, static_cast<std::uint16_t>(node.children.size()), node.flags});
+    unique_nodes->emplace(std::move(key), id);
+    return id;
+  }
+
+  std::vector<trie_node> trie_ = std::vector<trie_node>(1);
+};
+}  // namespace details
+
+/// A compiled [Public Suffix List](https://publicsuffix.org/).
+///
+/// The rules are stored as a DAFSA over domain labels, read from right to
+/// left: each node is a set of rules, and identical sets (e.g. the
+/// hundreds of two level domains under different country codes) are
+/// stored once. A lookup walks the labels of the host from right to left,
+/// finding each transition in a hash table of edges, and returns a view
+/// into the host, so that it never allocates.
+///
+/// The list is either compiled at runtime with `compile` or `load`, or at
+/// build time into a header by `tools/make_public_suffix_table.cpp`. Copies
+/// share the compiled tables.
+///
+/// Hosts are expected to be in the form produced by the URL parser: ASCII,
+/// lowercase, and with internationalized labels encoded with Punycode.
+class public_suffix_list {
+ public:
+  /// Constructs a list with no rules, so that the public suffix of every
+  /// host is its last label
+  public_suffix_list() = default;
+
+  /// Constructs a list from tables that are compiled into the program
+  ///
+  /// \param nodes The nodes, with the root first
+  /// \param edges The edges
+  /// \param labels The label pool
+  /// \param index The hash table of edges, whose size is a power of two
+  constexpr public_suffix_list(std::span<const public_suffix_node> nodes, std::span<const public_suffix_edge> edges,
+                               std::string_view labels, std::span<const std::uint32_t> index) noexcept
+      : nodes_(nodes), edges_(edges), labels_(labels), index_(index) {
+  }
+
+  /// Compiles the contents of a `public_suffix_list.dat` file
+  ///
+  /// \param contents The list, in the [format](https://github.com/publicsuffix/list/wiki/Format) of
+  ///        `public_suffix_list.dat`
+  /// \returns The compiled list, or an error
+  static auto compile(std::string_view contents) -> std::expected<public_suffix_list, public_suffix_errc> {
+    constexpr auto whitespace = std::string_view(" \t\r");
+
+    auto builder = details::public_suffix_builder{};
+    auto is_private = false;
+    while (!contents.empty()) {
+      auto end_of_line = contents.find('\n');
+      auto line = contents.substr(0, end_of_line);
+      contents.remove_prefix((end_of_line == std::string_view::npos) ? contents.size() : end_of_line + 1);
+
+      auto first = line.find_first_not_of(whitespace);
+      if (first == std::string_view::npos) {
+        continue;
+      }
+      line.remove_prefix(first);
+
+      if (line.starts_with("//")) {
+        if (line.contains("===BEGIN PRIVATE DOMAINS===")) {
+          is_private = true;
+        } else if (line.contains("===END PRIVATE DOMAINS===")) {
+          is_private = false;
+        }
+        continue;
+      }
+
+      // Anything after the rule is a comment
+      auto result = builder.insert(line.substr(0, line.find_first_of(whitespace)), is_private);
+      if (!result) {
+        return std::unexpected(result.error());
+      }
+    }
+
+    auto storage = builder.build();
+    if (!storage) {
+      return std::unexpected(storage.error());
+    }
+
+    auto list = public_suffix_list{};
+    auto shared = std::make_shared<const details::public_suffix_storage>(std::move(storage).value());
+    list.nodes_ = shared->nodes;
+    list.edges_ = shared->edges;
+    list.labels_ = shared->labels;
+    list.index_ = shared->index;
+    list.storage_ = std::move(shared);
+    return list;
+  }
+
+  /// Loads and compiles a `public_suffix_list.dat` file
+  ///
+  /// \param path The path of the file
+  /// \returns The compiled list, or an error
+  static auto load(const std::filesystem::path& path) -> std::expected<public_suffix_list, public_suffix_errc> {
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file) {
+      return std::unexpected(public_suffix_errc::cannot_open_file);
+    }
+    auto contents = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+      return std::unexpected(public_suffix_errc::cannot_open_file);
+    }
+    return compile(contents);
+  }
+
+  /// Finds the public suffix of a host, e.g. `co.uk` for `www.example.co.uk`
+  ///
+  /// \param host A domain
+  /// \param include_private Whether to apply the rules in the private
+  ///        section of the list, e.g. `github.io`
+  /// \returns A view of the public suffix in `host`, which keeps the
+  ///          trailing dot of `host` if it has one, or `std::nullopt` if
+  ///          `host` is empty, has an empty label or is an IP address
+  [[nodiscard]] auto public_suffix(std::string_view host, bool include_private = true) const noexcept
+      -> std::optional<std::string_view> {
+    auto suffix = match(host, include_private);
+    if (!suffix) {
+      return std::nullopt;
+    }
+    return host.substr(suffix.value());
+  }
+
+  /// Finds the registrable domain of a host, which is its public suffix and
+  /// the label before it, e.g. `example.co.uk` for `www.example.co.uk`
+  ///
+  /// \param host A domain
+  /// \param include_private Whether to apply the rules in the private
+  ///        section of the list, e.g. `github.io`
+  /// \returns A view of the registrable domain in `host`, which keeps the
+  ///          trailing dot of `host` if it has one, or `std::nullopt` if
+  ///          `host` is itself a public suffix, or has no public suffix
+  [[nodiscard]] auto registrable_domain(std::string_view host, bool include_private = true) const noexcept
+      -> std::optional<std::string_view> {
+    auto suffix = match(host, include_private);
+    if (!suffix || (suffix.value() < 2)) {
+      return std::nullopt;
+    }
+    auto dot = host.rfind('.', suffix.value() - 2);
+    return host.substr((dot == std::string_view::npos) ? 0 : dot + 1);
+  }
+
+  /// Tests whether two hosts are
+  /// [schemelessly same site](https://html.spec.whatwg.org/multipage/browsers.html#schemelessly-same-site)
+  ///
+  /// \param first A domain
+  /// \param second A domain
+  /// \param include_private Whether to apply the rules in the private
+  ///        section of the list, e.g. `github.io`
+  /// \returns `true` if the hosts have the same registrable domain, or
+  ///          are the same host if they have none. As in the
+  ///          specification, a host with a trailing dot is not the same
+  ///          site as the host without it
+  [[nodiscard]] auto is_same_site(std::string_view first, std::string_view second,
+                                  bool include_private = true) const noexcept -> bool {
+    auto first_domain = registrable_domain(first, include_private);
+    if (!first_domain) {
+      return first == second;
+    }
+    auto second_domain = registrable_domain(second, include_private);
+    return second_domain && (first_domain.value() == second_domain.value());
+  }
+
+  /// \returns The nodes of the compiled list, with the root first
+  [[nodiscard]] constexpr auto nodes() const noexcept -> std::span<const public_suffix_node> {
+    return nodes_;
+  }
+
+  /// \returns The edges of the compiled list
+  [[nodiscard]] constexpr auto edges() const noexcept -> std::span<const public_suffix_edge> {
+    return edges_;
+  }
+
+  /// \returns The label pool of the compiled list
+  [[nodiscard]] constexpr auto labels() const noexcept -> std::string_view {
+    return labels_;
+  }
+
+  /// \returns The hash table of edges of the compiled list
+  [[nodiscard]] constexpr auto index() const noexcept -> std::span<const std::uint32_t> {
+    return index_;
+  }
+
+ private:
+  [[nodiscard]] auto find_child(const public_suffix_node& node, std::string_view label) const noexcept
+      -> const public_suffix_node* {
+    if (node.edge_count == 0) {
+      return nullptr;
+    }
+
+    auto mask = index_.size() - 1;
+    auto slot = details::public_suffix_hash(static_cast<std::uint32_t>(&node - nodes_.data()), label) & mask;
+    for (; index_[slot] != details::public_suffix_no_edge; slot = (slot + 1) & mask) {
+      auto edge_index = index_[slot];
+      const auto& edge = edges_[edge_index];
+      if ((edge_index - node.first_edge < node.edge_count) && (edge.label_length == label.size()) &&
+          std::equal(label.begin(), label.end(), labels_.begin() + edge.label_offset)) {
+        return &nodes_[edge.node];
+      }
+    }
+    return nullptr;
+  }
+
+  /// Applies the [algorithm](https://github.com/publicsuffix/list/wiki/Format#algorithm) to find the public suffix
+  ///
+  /// \param host A domain, which may have a trailing dot
+  /// \param include_private Whether to apply the rules in the private section
+  /// \returns The offset of the public suffix in `host`, or `std::nullopt`
+  ///          if `host` is empty, has an empty label or is an IP address
+  [[nodiscard]] auto match(std::string_view host, bool include_private) const noexcept -> std::optional<std::size_t> {
+    using namespace public_suffix_flags;
+
+    constexpr auto is_digit = [](auto byte) { return (byte >= '0') && (byte <= '9'); };
+
+    // A trailing dot is kept in the result, but isn't a label
+    auto name = host.ends_with('.') ? host.substr(0, host.size() - 1) : host;
+    if (name.empty() || name.starts_with('.') || name.ends_with('.') || name.starts_with('[') ||
+        name.contains("..")) {
+      return std::nullopt;
+    }
+
+    auto active_flags = [include_private](const public_suffix_node& node) -> std::uint8_t {
+      return (include_private ? (node.flags | (node.flags >> private_shift)) : node.flags) & 0x07;
+    };
+
+    auto end = name.size();
+    auto dot = name.rfind('.');
+    auto first = (dot == std::string_view::npos) ? 0 : dot + 1;
+    if (std::ranges::all_of(name.substr(first), is_digit)) {
+      // An IPv4 address
+      return std::nullopt;
+    }
+
+    // The default rule is `*`
+    auto suffix = first;
+    const auto* node = nodes_.empty() ? nullptr : &nodes_.front();
+    while (node != nullptr) {
+      auto label = name.substr(first, end - first);
+      auto flags = active_flags(*node);
+      const auto* child = find_child(*node, label);
+      if ((child != nullptr) && (active_flags(*child) & exception) && (end < name.size())) {
+        // The exception rule's public suffix is its parent
+        suffix = end + 1;
+        break;
+      }
+      if (flags & wildcard) {
+        suffix = first;
+      }
+      if (child == nullptr) {
+        break;
+      }
+      if (active_flags(*child) & rule) {
+        suffix = first;
+      }
+
+      if (first == 0) {
+        break;
+      }
+      node = child;
+      end = first - 1;
+      dot = name.rfind('.', end - 1);
+      first = (dot == std::string_view::npos) ? 0 : dot + 1;
+    }
+    return suffix;
+  }
+
+  std::shared_ptr<const details::public_suffix_storage> storage_;
+  std::span<const public_suffix_node> nodes_;
+  std::span<const public_suffix_edge> edges_;
+  std::string_view labels_;
+  std::span<const std::uint32_t> index_;
+};
+}  // namespace skyr
+
+#endif  // SKYR_PUBLIC_SUFFIX_PUBLIC_SUFFIX_LIST_HPP
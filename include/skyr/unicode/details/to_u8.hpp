@@ -6,7 +6,9 @@
 #ifndef SKYR_UNICODE_DETAILS_TO_U8_HPP
 #define SKYR_UNICODE_DETAILS_TO_U8_HPP
 
+#include <iterator>
 #include <string>
+#include <string_view>
 
 #include <skyr/concepts/url_concepts.hpp>
 #include <skyr/unicode/errors.hpp>
@@ -14,40 +16,42 @@
 #include <skyr/unicode/ranges/views/u16_view.hpp>
 
 namespace skyr::details {
-template <class Source>
-  requires is_string_container<Source, char>
-auto to_u8(const Source& source) -> std::expected<std::string, unicode::unicode_errc> {
-  // For char arrays/pointers (null-terminated), find the actual end excluding null terminator
-  auto begin = std::cbegin(source);
-  auto end = std::cend(source);
-
-  // If this is a null-terminated string, exclude the null terminator
-  if constexpr (is_char_array<Source, char> || is_char_pointer<Source, char>) {
-    // Find the actual end (before null terminator)
-    while (begin != end && *(end - 1) == char{0}) {
-      --end;
+/// \returns A view of a string container, without any terminating null
+///          characters
+template <class charT, class Source>
+  requires is_string_container<Source, charT>
+constexpr auto as_basic_string_view(const Source& source) noexcept -> std::basic_string_view<charT> {
+  if constexpr (is_char_pointer<Source, charT>) {
+    return std::basic_string_view<charT>(source);
+  } else {
+    auto view = std::basic_string_view<charT>(std::data(source), std::size(source));
+    if constexpr (is_char_array<Source, charT>) {
+      // Exclude the null terminator of a string literal
+      while (!view.empty() && (view.back() == charT{0})) {
+        view.remove_suffix(1);
+      }
     }
+    return view;
   }
+}
 
-  return std::string(begin, end);
+/// UTF-8 sources are passed through without being copied
+///
+/// \returns A view of the source, which must outlive the result
+template <class Source>
+  requires is_string_container<Source, char>
+constexpr auto to_u8(const Source& source) noexcept -> std::expected<std::string_view, unicode::unicode_errc> {
+  return as_basic_string_view<char>(source);
 }
 
+/// UTF-8 sources are passed through without being copied
+///
+/// \returns A view of the source, which must outlive the result
 template <class Source>
   requires is_string_container<Source, char8_t>
-auto to_u8(const Source& source) -> std::expected<std::string, unicode::unicode_errc> {
-  // For char8_t arrays/pointers (null-terminated), find the actual end excluding null terminator
-  auto begin = std::cbegin(source);
-  auto end = std::cend(source);
-
-  // If this is a null-terminated string, exclude the null terminator
-  if constexpr (is_char_array<Source, char8_t> || is_char_pointer<Source, char8_t>) {
-    // Find the actual end (before null terminator)
-    while (begin != end && *(end - 1) == char8_t{0}) {
-      --end;
-    }
-  }
-
-  return std::string(begin, end);
+auto to_u8(const Source& source) noexcept -> std::expected<std::string_view, unicode::unicode_errc> {
+  auto view = as_basic_string_view<char8_t>(source);
+  return std::string_view(reinterpret_cast<const char*>(view.data()), view.size());  // NOLINT
 }
 
 template <class Source>
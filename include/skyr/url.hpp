@@ -6,21 +6,35 @@
 #ifndef SKYR_URL_HPP
 #define SKYR_URL_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <format>
+#include <functional>
+#include <memory>
 #include <ostream>
+#include <ranges>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <utility>
 
 #include <skyr/config.hpp>
 #include <skyr/core/errors.hpp>
 #include <skyr/core/parse.hpp>
+#include <skyr/core/rewrite_query.hpp>
 #include <skyr/core/serialize.hpp>
 #include <skyr/core/url_parse_state.hpp>
 #include <skyr/core/url_record.hpp>
+#include <skyr/details/url_storage.hpp>
 #include <skyr/domain/domain.hpp>
+#include <skyr/domain/domain_cache.hpp>
 #include <skyr/network/ipv4_address.hpp>
 #include <skyr/network/ipv6_address.hpp>
+#include <skyr/origin.hpp>
+#include <skyr/percent_encoding/decoded_view.hpp>
 #include <skyr/percent_encoding/percent_encoded_char.hpp>
 #include <skyr/unicode/details/to_u8.hpp>
 #include <skyr/url_search_parameters.hpp>
@@ -36,6 +50,13 @@
 namespace skyr {
 namespace details {
 auto make_url(std::string_view input, const url_record* base) -> std::expected<url, url_parse_errc>;
+
+/// \param pred A predicate that tests whether a byte is in a percent encode set
+/// \returns A predicate that tests whether a character would be percent encoded
+template <class Pred>
+constexpr auto is_encoded_byte(Pred pred) noexcept {
+  return [pred](char byte) { return pred(std::byte(byte)); };
+}
 }  // namespace details
 
 /// Thrown when there is an error parsing the URL
@@ -62,6 +83,9 @@ class url_parse_error : public std::runtime_error {
 /// The API follows closely the
 /// [WhatWG IDL specification](https://url.spec.whatwg.org/#url-class).
 class url {
+  friend class url_builder;
+  friend class skyr::origin;
+
  public:
   /// The internal ASCII string type, or `std::basic_string<value_type>`
   using string_type = std::string;
@@ -83,7 +107,7 @@ class url {
   /// Constructs an empty `url` object
   ///
   /// \post `empty() == true`
-  url() : url_(), href_(), view_(href_), parameters_(this) {
+  url() : storage_(details::empty_url_storage()) {
   }
 
   /// Parses a URL from the input string. The input string can be
@@ -128,24 +152,42 @@ class url {
   }
 
   /// Copy constructor
+  ///
+  /// The copy shares the same immutable storage as `other`, so
+  /// copying a `url` only increments an atomic reference count.
+  /// The storage is cloned when either copy is modified.
+  ///
   /// \param other Another `url` object
-  url(const url& other) : url(url_record(other.url_)) {
+  url(const url& other) : storage_(other.share_storage()) {
   }
 
   /// Move constructor
   /// \param other Another `url` object
-  url(url&& other) noexcept : url(std::move(other.url_)) {
+  /// \post `other.empty() == true`
+  url(url&& other) noexcept : storage_(std::exchange(other.storage_, details::empty_url_storage())) {
+    adopt_search_parameters();
   }
 
   /// Copy assignment operator
   /// \param other Another `url` object
   /// \return *this
-  url& operator=(const url& other) = default;
+  url& operator=(const url& other) {
+    if (this != &other) {
+      storage_ = other.share_storage();
+    }
+    return *this;
+  }
 
   /// Move assignment operator
   /// \param other Another `url` object
   /// \return *this
-  url& operator=(url&& other) = default;
+  url& operator=(url&& other) noexcept {
+    if (this != &other) {
+      storage_ = std::exchange(other.storage_, details::empty_url_storage());
+      adopt_search_parameters();
+    }
+    return *this;
+  }
 
   /// Destructor
   ~url() = default;
@@ -155,11 +197,9 @@ class url {
   /// \param other Another `url` object
   void swap(url& other) noexcept {
     using std::swap;
-    swap(url_, other.url_);
-    swap(href_, other.href_);
-    view_ = string_view(href_);
-    other.view_ = string_view(other.href_);
-    swap(parameters_, other.parameters_);
+    swap(storage_, other.storage_);
+    adopt_search_parameters();
+    other.adopt_search_parameters();
   }
 
   /// Returns the [serialization of the context object’s url](https://url.spec.whatwg.org/#dom-url-href)
@@ -169,7 +209,15 @@ class url {
   /// \returns The serialization of the context object's url
   /// \sa to_json
   [[nodiscard]] auto href() const -> string_type {
-    return href_;
+    return storage_->href;
+  }
+
+  /// Returns the [serialization of the context object’s url](https://url.spec.whatwg.org/#dom-url-href)
+  ///
+  /// \returns A view of the serialization of the context object's url,
+  ///          valid until this object is modified or destroyed
+  [[nodiscard]] auto href_view() const noexcept -> string_view {
+    return storage_->href;
   }
 
   /// Sets the context object's url according to the
@@ -210,35 +258,41 @@ class url {
   /// \returns The serialization of the context object's url
   /// \sa href()
   [[nodiscard]] auto to_json() const -> string_type {
-    return href_;
+    return storage_->href;
   }
 
   /// Returns the [URL origin](https://url.spec.whatwg.org/#origin)
   ///
   /// \returns The [URL origin](https://url.spec.whatwg.org/#origin)
+  /// \sa skyr::origin
   [[nodiscard]] auto origin() const -> string_type {
-    if (url_.scheme == "blob") {
-      auto url = details::make_url(pathname(), nullptr);
+    const auto& scheme = storage_->record.scheme;
+    if (scheme == "blob") {
+      auto url = details::make_url(pathname_view(), nullptr);
       return url ? url.value().origin() : "";
-    } else if ((url_.scheme == "ftp") || (url_.scheme == "http") || (url_.scheme == "https") || (url_.scheme == "ws") ||
-               (url_.scheme == "wss")) {
-      return protocol() + "//" + host();
-    } else if (url_.scheme == "file") {
+    } else if (scheme == "file") {
       return "";
     }
-    return "null";
+    return skyr::origin(*this).serialize();
   }
 
   /// The URL scheme
   [[nodiscard]] auto scheme() const -> string_type {
-    return url_.scheme;
+    return storage_->record.scheme;
   }
 
   /// The URL scheme + `":"`
   ///
   /// \returns The [URL protocol](https://url.spec.whatwg.org/#dom-url-protocol)
   [[nodiscard]] auto protocol() const -> string_type {
-    return url_.scheme + ":";
+    return string_type(protocol_view());
+  }
+
+  /// The URL scheme + `":"`
+  ///
+  /// \returns A view of the [URL protocol](https://url.spec.whatwg.org/#dom-url-protocol)
+  [[nodiscard]] auto protocol_view() const noexcept -> string_view {
+    return component_view(0, storage_->offsets.protocol_end);
   }
 
   /// Sets the [URL protocol](https://url.spec.whatwg.org/#dom-url-protocol)
@@ -269,7 +323,8 @@ class url {
     }
 
     bool validation_error = false;
-    auto new_url = details::basic_parse(protocol, &validation_error, nullptr, &url_, url_parse_state::scheme_start);
+    auto new_url =
+        details::basic_parse(protocol, &validation_error, nullptr, &storage_->record, url_parse_state::scheme_start);
     if (!new_url) {
       return new_url.error();
     }
@@ -279,7 +334,12 @@ class url {
 
   /// \returns The [URL username](https://url.spec.whatwg.org/#dom-url-username)
   [[nodiscard]] auto username() const -> string_type {
-    return url_.username;
+    return storage_->record.username;
+  }
+
+  /// \returns A view of the [URL username](https://url.spec.whatwg.org/#dom-url-username)
+  [[nodiscard]] auto username_view() const noexcept -> string_view {
+    return component_view(storage_->offsets.username_begin, storage_->offsets.username_end);
   }
 
   /// Sets the [URL username](https://url.spec.whatwg.org/#dom-url-username)
@@ -302,11 +362,11 @@ class url {
   /// \param username The new username
   /// \returns An error on failure to parse the new URL
   auto set_username(string_view username) -> std::error_code {
-    if (url_.cannot_have_a_username_password_or_port()) {
+    if (storage_->record.cannot_have_a_username_password_or_port()) {
       return make_error_code(url_parse_errc::cannot_have_a_username_password_or_port);
     }
 
-    auto new_url = url_;
+    auto new_url = storage_->record;
 
     new_url.username.clear();
     for (auto c : username) {
@@ -318,13 +378,38 @@ class url {
     return {};
   }
 
+  /// Sets the [URL username](https://url.spec.whatwg.org/#dom-url-username)
+  ///
+  /// If no byte needs to be percent encoded, the string is moved into
+  /// the URL rather than copied.
+  ///
+  /// \param username The new username
+  /// \returns An error on failure to parse the new URL
+  auto set_username(string_type&& username) -> std::error_code {
+    if (std::ranges::any_of(username, details::is_encoded_byte(percent_encoding::details::is_userinfo_byte))) {
+      return set_username(string_view(username));
+    }
+    if (storage_->record.cannot_have_a_username_password_or_port()) {
+      return make_error_code(url_parse_errc::cannot_have_a_username_password_or_port);
+    }
+
+    mutable_storage().record.username = std::move(username);
+    refresh_storage();
+    return {};
+  }
+
   /// The [URL password](https://url.spec.whatwg.org/#dom-url-password)
   ///
-  /// Equivalent to: `url_.password? url_.password.value() : string_type()`
+  /// Equivalent to: `storage_->record.password? storage_->record.password.value() : string_type()`
   ///
   /// \returns The URL password
   [[nodiscard]] auto password() const -> string_type {
-    return url_.password;
+    return storage_->record.password;
+  }
+
+  /// \returns A view of the [URL password](https://url.spec.whatwg.org/#dom-url-password)
+  [[nodiscard]] auto password_view() const noexcept -> string_view {
+    return component_view(storage_->offsets.password_begin, storage_->offsets.password_end);
   }
 
   /// Sets the [URL password](https://url.spec.whatwg.org/#dom-url-password)
@@ -347,11 +432,11 @@ class url {
   /// \param password The new password
   /// \returns An error on failure to parse the new URL
   auto set_password(string_view password) -> std::error_code {
-    if (url_.cannot_have_a_username_password_or_port()) {
+    if (storage_->record.cannot_have_a_username_password_or_port()) {
       return make_error_code(url_parse_errc::cannot_have_a_username_password_or_port);
     }
 
-    auto new_url = url_;
+    auto new_url = storage_->record;
 
     new_url.password.clear();
     for (auto c : password) {
@@ -363,17 +448,34 @@ class url {
     return {};
   }
 
-  /// \returns The [URL host](https://url.spec.whatwg.org/#dom-url-host)
-  [[nodiscard]] auto host() const -> string_type {
-    if (!url_.host) {
-      return {};
+  /// Sets the [URL password](https://url.spec.whatwg.org/#dom-url-password)
+  ///
+  /// If no byte needs to be percent encoded, the string is moved into
+  /// the URL rather than copied.
+  ///
+  /// \param password The new password
+  /// \returns An error on failure to parse the new URL
+  auto set_password(string_type&& password) -> std::error_code {
+    if (std::ranges::any_of(password, details::is_encoded_byte(percent_encoding::details::is_userinfo_byte))) {
+      return set_password(string_view(password));
     }
-
-    if (!url_.port) {
-      return url_.host.value().serialize();
+    if (storage_->record.cannot_have_a_username_password_or_port()) {
+      return make_error_code(url_parse_errc::cannot_have_a_username_password_or_port);
     }
 
-    return url_.host.value().serialize() + ":" + std::to_string(url_.port.value());
+    mutable_storage().record.password = std::move(password);
+    refresh_storage();
+    return {};
+  }
+
+  /// \returns The [URL host](https://url.spec.whatwg.org/#dom-url-host)
+  [[nodiscard]] auto host() const -> string_type {
+    return string_type(host_view());
+  }
+
+  /// \returns A view of the [URL host](https://url.spec.whatwg.org/#dom-url-host)
+  [[nodiscard]] auto host_view() const noexcept -> string_view {
+    return component_view(storage_->offsets.hostname_begin, storage_->offsets.port_end);
   }
 
   /// Sets the [URL host](https://url.spec.whatwg.org/#dom-url-host)
@@ -396,15 +498,15 @@ class url {
   /// \param host The new URL host
   /// \returns An error on failure to parse the new URL
   auto set_host(string_view host) -> std::error_code {
-    if (url_.cannot_be_a_base_url) {
+    if (storage_->record.cannot_be_a_base_url) {
       return make_error_code(url_parse_errc::cannot_be_a_base_url);
     }
 
     bool validation_error = false;
-    auto new_url = details::basic_parse(host, &validation_error, nullptr, &url_, url_parse_state::host);
+    auto new_url = details::basic_parse(host, &validation_error, nullptr, &storage_->record, url_parse_state::host);
     if (!new_url) {
       if (new_url.error() == url_parse_errc::invalid_port) {
-        new_url = details::basic_parse(host, &validation_error, nullptr, &url_, url_parse_state::hostname);
+        new_url = details::basic_parse(host, &validation_error, nullptr, &storage_->record, url_parse_state::hostname);
         if (!new_url) {
           return new_url.error();
         }
@@ -418,11 +520,12 @@ class url {
 
   /// \returns The [URL hostname](https://url.spec.whatwg.org/#dom-url-hostname)
   [[nodiscard]] auto hostname() const -> string_type {
-    if (!url_.host) {
-      return {};
-    }
+    return string_type(hostname_view());
+  }
 
-    return url_.host.value().serialize();
+  /// \returns A view of the [URL hostname](https://url.spec.whatwg.org/#dom-url-hostname)
+  [[nodiscard]] auto hostname_view() const noexcept -> string_view {
+    return component_view(storage_->offsets.hostname_begin, storage_->offsets.hostname_end);
   }
 
   /// Sets the [URL hostname](https://url.spec.whatwg.org/#dom-url-hostname)
@@ -445,12 +548,13 @@ class url {
   /// \param hostname The new URL host name
   /// \returns An error on failure to parse the new URL
   auto set_hostname(string_view hostname) -> std::error_code {
-    if (url_.cannot_be_a_base_url) {
+    if (storage_->record.cannot_be_a_base_url) {
       return make_error_code(url_parse_errc::cannot_be_a_base_url);
     }
 
     bool validation_error = false;
-    auto new_url = details::basic_parse(hostname, &validation_error, nullptr, &url_, url_parse_state::hostname);
+    auto new_url =
+        details::basic_parse(hostname, &validation_error, nullptr, &storage_->record, url_parse_state::hostname);
     if (!new_url) {
       return new_url.error();
     }
@@ -460,12 +564,12 @@ class url {
 
   /// Checks if the hostname is a valid domain name
   [[nodiscard]] auto is_domain() const -> bool {
-    return url_.is_special() && !hostname().empty() && !is_ipv4_address() && !is_ipv6_address();
+    return storage_->record.is_special() && !hostname_view().empty() && !is_ipv4_address() && !is_ipv6_address();
   }
 
   /// Returns an optional domain name
   [[nodiscard]] auto domain() const -> std::optional<string_type> {
-    return url_.host ? url_.host.value().to_domain_name() : std::nullopt;
+    return storage_->record.host ? storage_->record.host.value().to_domain_name() : std::nullopt;
   }
 
   /// Returns an optional domain after decoding as a UTF-8 string
@@ -474,14 +578,14 @@ class url {
     auto domain = this->domain();
     if (domain) {
       auto u8_domain = std::string{};
-      return domain_to_u8(domain.value(), &u8_domain) ? std::make_optional(u8_domain) : std::nullopt;
+      return cached_domain_to_u8(domain.value(), &u8_domain) ? std::make_optional(u8_domain) : std::nullopt;
     }
     return domain;
   }
 
   /// Checks if the hostname is a valid IPv4 address
   [[nodiscard]] auto is_ipv4_address() const -> bool {
-    return (url_.host && url_.host.value().is_ipv4_address());
+    return (storage_->record.host && storage_->record.host.value().is_ipv4_address());
   }
 
   /// Returns an optional ipv4_address value if the hostname is a
@@ -490,12 +594,12 @@ class url {
     if (!is_ipv4_address()) {
       return std::nullopt;
     }
-    return url_.host.value().to_ipv4_address();
+    return storage_->record.host.value().to_ipv4_address();
   }
 
   /// Checks if the hostname is a valid IPv6 address
   [[nodiscard]] auto is_ipv6_address() const -> bool {
-    return (url_.host && url_.host.value().is_ipv6_address());
+    return (storage_->record.host && storage_->record.host.value().is_ipv6_address());
   }
 
   /// Returns an optional ipv6_address value if the hostname is a
@@ -504,28 +608,31 @@ class url {
     if (!is_ipv6_address()) {
       return std::nullopt;
     }
-    return url_.host.value().to_ipv6_address();
+    return storage_->record.host.value().to_ipv6_address();
   }
 
   /// Checks if the hostname is a valid opaque host
   [[nodiscard]] auto is_opaque_host() const -> bool {
-    return url_.host && url_.host.value().is_opaque_host();
+    return storage_->record.host && storage_->record.host.value().is_opaque_host();
   }
 
   /// Checks if the hostname is a valid domain name
   [[nodiscard]] auto is_empty_host() const -> bool {
-    return url_.host && url_.host.value().is_empty();
+    return storage_->record.host && storage_->record.host.value().is_empty();
   }
 
   /// Returns the [URL port](https://url.spec.whatwg.org/#dom-url-port)
   ///
   /// \returns The [URL port](https://url.spec.whatwg.org/#dom-url-port)
   [[nodiscard]] auto port() const -> string_type {
-    if (!url_.port) {
-      return {};
-    }
+    return string_type(port_view());
+  }
 
-    return std::to_string(url_.port.value());
+  /// Returns the [URL port](https://url.spec.whatwg.org/#dom-url-port)
+  ///
+  /// \returns A view of the [URL port](https://url.spec.whatwg.org/#dom-url-port)
+  [[nodiscard]] auto port_view() const noexcept -> string_view {
+    return component_view(storage_->offsets.port_begin, storage_->offsets.port_end);
   }
 
   /// Returns the [URL port](https://url.spec.whatwg.org/#dom-url-port)
@@ -533,14 +640,10 @@ class url {
   /// \returns The [URL port](https://url.spec.whatwg.org/#dom-url-port)
   template <typename intT>
   [[nodiscard]] auto port(std::enable_if_t<std::is_integral_v<intT>>* = nullptr) const -> std::optional<intT> {
-    auto p = port();
-    if (p.empty()) {
+    if (!storage_->record.port) {
       return std::nullopt;
     }
-
-    const char* port_first = p.data();
-    char* port_last = nullptr;
-    return static_cast<intT>(std::strtoul(port_first, &port_last, 10));
+    return static_cast<intT>(storage_->record.port.value());
   }
 
   /// Sets the [URL port](https://url.spec.whatwg.org/#dom-url-port)
@@ -574,17 +677,17 @@ class url {
   /// \param port The new port
   /// \returns An error on failure to parse the new URL
   auto set_port(string_view port) -> std::error_code {
-    if (url_.cannot_have_a_username_password_or_port()) {
+    if (storage_->record.cannot_have_a_username_password_or_port()) {
       return make_error_code(url_parse_errc::cannot_have_a_username_password_or_port);
     }
 
     if (port.empty()) {
-      auto new_url = url_;
+      auto new_url = storage_->record;
       new_url.port = std::nullopt;
       update_record(std::move(new_url));
     } else {
       bool validation_error = false;
-      auto new_url = details::basic_parse(port, &validation_error, nullptr, &url_, url_parse_state::port);
+      auto new_url = details::basic_parse(port, &validation_error, nullptr, &storage_->record, url_parse_state::port);
       if (!new_url) {
         return new_url.error();
       }
@@ -598,20 +701,38 @@ class url {
   ///
   /// \returns The URL pathname
   [[nodiscard]] auto pathname() const -> string_type {
-    if (url_.cannot_be_a_base_url) {
-      return url_.path.front();
-    }
+    return string_type(pathname_view());
+  }
 
-    if (url_.path.empty()) {
-      return {};
-    }
+  /// Returns the [URL pathname](https://url.spec.whatwg.org/#dom-url-pathname)
+  ///
+  /// \returns A view of the URL pathname
+  [[nodiscard]] auto pathname_view() const noexcept -> string_view {
+    return component_view(storage_->offsets.pathname_begin, storage_->offsets.search_begin);
+  }
 
-    auto pathname = string_type("/");
-    for (const auto& segment : url_.path) {
-      pathname += segment;
-      pathname += "/";
-    }
-    return pathname.substr(0, pathname.length() - 1);
+  /// Returns a view of the URL pathname that is percent decoded as it is
+  /// iterated or compared
+  ///
+  /// ```
+  /// auto url = skyr::url("https://example.com/caf%C3%A9/menu");
+  /// assert(url.decoded_pathname_view().starts_with("/café/"));
+  /// ```
+  ///
+  /// \returns A decoded view of the URL pathname
+  [[nodiscard]] auto decoded_pathname_view() const noexcept -> percent_encoding::decoded_view {
+    return percent_encoding::decoded_view(pathname_view());
+  }
+
+  /// Returns a decoded view of each URL path segment, so that segments
+  /// can be matched without allocating. A URL with an opaque path has a
+  /// single segment.
+  ///
+  /// \returns A range of `percent_encoding::decoded_view`
+  [[nodiscard]] auto decoded_path_segments() const noexcept {
+    return storage_->record.path | std::views::transform([](const string_type& segment) {
+             return percent_encoding::decoded_view(segment);
+           });
   }
 
   /// Sets the [URL pathname](https://url.spec.whatwg.org/#dom-url-pathname)
@@ -634,13 +755,14 @@ class url {
   /// \param pathname The new pathname
   /// \returns An error on failure to parse the new URL
   auto set_pathname(string_view pathname) -> std::error_code {
-    if (url_.cannot_be_a_base_url) {
+    if (storage_->record.cannot_be_a_base_url) {
       return make_error_code(url_parse_errc::cannot_be_a_base_url);
     }
 
-    url_.path.clear();
+    auto url = storage_->record;
+    url.path.clear();
     bool validation_error = false;
-    auto new_url = details::basic_parse(pathname, &validation_error, nullptr, &url_, url_parse_state::path_start);
+    auto new_url = details::basic_parse(pathname, &validation_error, nullptr, &url, url_parse_state::path_start);
     if (!new_url) {
       return new_url.error();
     }
@@ -652,11 +774,15 @@ class url {
   ///
   /// \returns The [URL search string](https://url.spec.whatwg.org/#dom-url-search)
   [[nodiscard]] auto search() const -> string_type {
-    if (!url_.query || url_.query.value().empty()) {
-      return {};
-    }
+    return string_type(search_view());
+  }
 
-    return "?" + url_.query.value();
+  /// Returns the [URL search string](https://url.spec.whatwg.org/#dom-url-search)
+  ///
+  /// \returns A view of the [URL search string](https://url.spec.whatwg.org/#dom-url-search)
+  [[nodiscard]] auto search_view() const noexcept -> string_view {
+    auto search = component_view(storage_->offsets.search_begin, storage_->offsets.hash_begin);
+    return (search.size() > 1) ? search : string_view{};
   }
 
   /// Sets the [URL search string](https://url.spec.whatwg.org/#dom-url-search)
@@ -679,7 +805,7 @@ class url {
   /// \param search The new search string
   /// \returns An error on failure to parse the new URL
   auto set_search(string_view search) -> std::error_code {
-    auto url = url_;
+    auto url = storage_->record;
     if (search.empty()) {
       url.query = std::nullopt;
       update_record(std::move(url));
@@ -700,25 +826,60 @@ class url {
     return {};
   }
 
+  /// Sets the [URL search string](https://url.spec.whatwg.org/#dom-url-search)
+  ///
+  /// If no byte needs to be percent encoded, the string is moved into
+  /// the URL rather than copied.
+  ///
+  /// \param search The new search string
+  /// \returns An error on failure to parse the new URL
+  auto set_search(string_type&& search) -> std::error_code {
+    auto is_encoded = details::is_encoded_byte(storage_->record.is_special()
+                                                   ? percent_encoding::details::is_special_query_byte
+                                                   : percent_encoding::details::is_query_byte);
+    auto first = (!search.empty() && (search.front() == '?')) ? 1 : 0;
+    if (search.empty() || std::ranges::any_of(std::next(search.begin(), first), search.end(), is_encoded)) {
+      return set_search(string_view(search));
+    }
+
+    search.erase(0, first);
+    mutable_storage().record.query = std::move(search);
+    refresh_storage();
+    return {};
+  }
+
+  /// Returns a mutable reference to the search parameters
+  ///
+  /// If the storage is shared with other copies, it is cloned
+  /// first. Because the returned reference can outlive this call,
+  /// the storage is no longer shared by subsequent copies.
+  ///
   /// \returns A reference to the search parameters
   [[nodiscard]] auto search_parameters() -> url_search_parameters& {
-    return parameters_;
+    auto& storage = mutable_storage();
+    storage.is_shareable = false;
+    storage.parameters.url_ = this;
+    return storage.parameters;
   }
 
   /// \returns A reference to the search parameters
   [[nodiscard]] auto search_parameters() const -> const url_search_parameters& {
-    return parameters_;
+    return storage_->parameters;
   }
 
   /// Returns the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
   ///
   /// \returns The [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
   [[nodiscard]] auto hash() const -> string_type {
-    if (!url_.fragment || url_.fragment.value().empty()) {
-      return {};
-    }
+    return string_type(hash_view());
+  }
 
-    return "#" + url_.fragment.value();
+  /// Returns the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
+  ///
+  /// \returns A view of the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
+  [[nodiscard]] auto hash_view() const noexcept -> string_view {
+    auto hash = component_view(storage_->offsets.hash_begin, storage_->href.size());
+    return (hash.size() > 1) ? hash : string_view{};
   }
 
   /// Sets the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
@@ -741,7 +902,7 @@ class url {
   /// \param hash The new hash string
   /// \returns An error on failure to parse the new URL
   auto set_hash(string_view hash) -> std::error_code {
-    auto url = url_;  // Copy first to avoid self-move
+    auto url = storage_->record;  // Copy first to avoid self-move
     if (hash.empty()) {
       url.fragment = std::nullopt;
       update_record(std::move(url));
@@ -762,18 +923,38 @@ class url {
     return {};
   }
 
+  /// Sets the [URL hash string](https://url.spec.whatwg.org/#dom-url-hash)
+  ///
+  /// If no byte needs to be percent encoded, the string is moved into
+  /// the URL rather than copied.
+  ///
+  /// \param hash The new hash string
+  /// \returns An error on failure to parse the new URL
+  auto set_hash(string_type&& hash) -> std::error_code {
+    auto is_encoded = details::is_encoded_byte(percent_encoding::details::is_fragment_byte);
+    auto first = (!hash.empty() && (hash.front() == '#')) ? 1 : 0;
+    if (hash.empty() || std::ranges::any_of(std::next(hash.begin(), first), hash.end(), is_encoded)) {
+      return set_hash(string_view(hash));
+    }
+
+    hash.erase(0, first);
+    mutable_storage().record.fragment = std::move(hash);
+    refresh_storage();
+    return {};
+  }
+
   /// The URL context object
   ///
   /// \returns The underlying `url_record` implementation.
   [[nodiscard]] auto record() const& noexcept -> const url_record& {
-    return url_;
+    return storage_->record;
   }
 
   /// The URL context object
   ///
   /// \returns The underlying `url_record` implementation.
-  [[nodiscard]] auto record() && noexcept -> url_record&& {
-    return std::move(url_);
+  [[nodiscard]] auto record() && -> url_record&& {
+    return std::move(mutable_storage().record);
   }
 
   /// Tests whether the URL uses a
@@ -782,21 +963,21 @@ class url {
   /// \returns `true` if the URL scheme is special, `false`
   ///          otherwise
   [[nodiscard]] auto is_special() const noexcept {
-    return url_.is_special();
+    return storage_->record.is_special();
   }
 
   /// An iterator to the beginning of the context object's string (`href_`)
   ///
   /// \returns An iterator to the beginning of the context object's string
   [[nodiscard]] auto begin() const noexcept {
-    return view_.begin();
+    return string_view(storage_->href).begin();
   }
 
   /// An iterator to the end of the context object's string (`href_`)
   ///
   /// \returns An iterator to the end of the URL string
   [[nodiscard]] auto end() const noexcept {
-    return view_.end();
+    return string_view(storage_->href).end();
   }
 
   /// Tests whether the URL is an empty string
@@ -804,13 +985,13 @@ class url {
   /// \returns `true` if the URL is an empty string, `false`
   ///          otherwise
   [[nodiscard]] auto empty() const noexcept {
-    return view_.empty();
+    return string_view(storage_->href).empty();
   }
 
   /// Gets the size of the URL buffer
   /// \return The size of the URL buffer
   [[nodiscard]] auto size() const noexcept {
-    return view_.size();
+    return string_view(storage_->href).size();
   }
 
   /// Compares this `url` object lexicographically with another
@@ -818,7 +999,7 @@ class url {
   /// \param other The other `url` object
   /// \returns `href_.compare(other.href_)`
   [[nodiscard]] auto compare(const url& other) const noexcept {
-    return view_.compare(other.view_);
+    return string_view(storage_->href).compare(other.storage_->href);
   }
 
   /// Returns the default port for
@@ -844,57 +1025,164 @@ class url {
   /// Returns a sanitized copy of this URL with credentials and fragment removed
   ///
   /// \returns A new URL object without credentials and fragment
-  [[nodiscard]] auto sanitize() const -> url {
-    auto sanitized_record = url_;
+  [[nodiscard]] auto sanitize() const& -> url {
+    return url(*this).sanitize();
+  }
+
+  /// Returns a sanitized URL with credentials and fragment removed
+  ///
+  /// The storage is reused if it is not shared with any other copy.
+  ///
+  /// \returns A new URL object without credentials and fragment
+  [[nodiscard]] auto sanitize() && -> url {
+    auto& record = mutable_storage().record;
 
     // Clear credentials
-    sanitized_record.username.clear();
-    sanitized_record.password.clear();
+    record.username.clear();
+    record.password.clear();
 
     // Clear fragment
-    sanitized_record.fragment.reset();
+    record.fragment.reset();
 
-    auto result = url();
-    result.update_record(std::move(sanitized_record));
-    return result;
+    refresh_storage();
+    return std::move(*this);
   }
 
   /// Returns a copy of this URL with the query string removed
   ///
   /// \returns A new URL object without the query string
-  [[nodiscard]] auto without_query() const -> url {
-    auto new_record = url_;
-    new_record.query.reset();
+  [[nodiscard]] auto without_query() const& -> url {
+    return url(*this).without_query();
+  }
 
-    auto result = url();
-    result.update_record(std::move(new_record));
-    return result;
+  /// Returns this URL with the query string removed
+  ///
+  /// The storage is reused if it is not shared with any other copy.
+  ///
+  /// \returns A new URL object without the query string
+  [[nodiscard]] auto without_query() && -> url {
+    mutable_storage().record.query.reset();
+    refresh_storage();
+    return std::move(*this);
   }
 
   /// Returns a copy of this URL with the fragment removed
   ///
   /// \returns A new URL object without the fragment
-  [[nodiscard]] auto without_fragment() const -> url {
-    auto new_record = url_;
-    new_record.fragment.reset();
+  [[nodiscard]] auto without_fragment() const& -> url {
+    return url(*this).without_fragment();
+  }
 
-    auto result = url();
-    result.update_record(std::move(new_record));
-    return result;
+  /// Returns this URL with the fragment removed
+  ///
+  /// The storage is reused if it is not shared with any other copy.
+  ///
+  /// \returns A new URL object without the fragment
+  [[nodiscard]] auto without_fragment() && -> url {
+    mutable_storage().record.fragment.reset();
+    refresh_storage();
+    return std::move(*this);
   }
 
   /// Returns a copy of this URL with specified query parameters removed
   ///
+  /// The remaining parameters are serialized again, as if by
+  /// `search_parameters().remove(name)`. Use `rewrite_query` to keep
+  /// them exactly as they are.
+  ///
   /// \param params List of parameter names to remove
   /// \returns A new URL object without the specified query parameters
   [[nodiscard]] auto without_params(std::initializer_list<std::string_view> params) const -> url {
     auto result = *this;
-    for (const auto& param : params) {
-      result.search_parameters().remove(param);
-    }
+    if (params.size() == 0) {
+      return result;
+    }
+
+    auto& parameters = result.mutable_storage().parameters;
+    parameters.url_ = &result;
+    std::erase_if(parameters.parameters_, [&params](const auto& parameter) {
+      return std::ranges::find(params, std::string_view(parameter.name)) != params.end();
+    });
+    parameters.update();
+    // `result` is copied or moved when it is returned
+    parameters.url_ = nullptr;
     return result;
   }
 
+  /// Returns a copy of this URL with its query parameters rewritten
+  ///
+  /// \tparam Rewrite A callable with the signature
+  ///         `query_rewrite(std::string_view name, std::string_view value)`
+  /// \param rewrite Decides whether to keep, drop or replace each parameter,
+  ///        given its raw (percent encoded) name and value
+  /// \returns A new URL object with the rewritten query
+  template <class Rewrite>
+    requires std::is_invocable_r_v<query_rewrite, Rewrite&, std::string_view, std::string_view>
+  [[nodiscard]] auto rewrite_query(Rewrite&& rewrite) const& -> url {
+    return url(*this).rewrite_query(std::forward<Rewrite>(rewrite));
+  }
+
+  /// Returns this URL with its query parameters rewritten
+  ///
+  /// The query is scanned once and the parameters that are kept are
+  /// copied verbatim into a single buffer, which is then spliced into the
+  /// serialized URL. Empty parameters are removed, and if every parameter
+  /// is dropped then the query is removed. The storage is only copied if
+  /// the query changes, and is reused if it is not shared with any other
+  /// copy.
+  ///
+  /// \tparam Rewrite A callable with the signature
+  ///         `query_rewrite(std::string_view name, std::string_view value)`
+  /// \param rewrite Decides whether to keep, drop or replace each parameter,
+  ///        given its raw (percent encoded) name and value
+  /// \returns A new URL object with the rewritten query
+  template <class Rewrite>
+    requires std::is_invocable_r_v<query_rewrite, Rewrite&, std::string_view, std::string_view>
+  [[nodiscard]] auto rewrite_query(Rewrite&& rewrite) && -> url {
+    const auto& current = storage_->record.query;
+    if (!current || current.value().empty()) {
+      return std::move(*this);
+    }
+
+    auto query = skyr::rewrite_query(current.value(), rewrite);
+    if (query == current.value()) {
+      return std::move(*this);
+    }
+
+    auto& storage = mutable_storage();
+    auto first = storage.offsets.search_begin;
+    auto count = storage.offsets.hash_begin - first;
+    if (query.empty()) {
+      storage.href.erase(first, count);
+      storage.record.query.reset();
+    } else {
+      storage.href.replace(first + 1, count - 1, query);
+      storage.record.query = std::move(query);
+    }
+    index_storage();
+    return std::move(*this);
+  }
+
+  /// Returns a copy of this URL without the query parameters whose
+  /// decoded names match a set of names or prefixes
+  ///
+  /// \param names The names of the parameters to remove
+  /// \returns A new URL object with the rewritten query
+  [[nodiscard]] auto rewrite_query(const query_name_set& names) const& -> url {
+    return url(*this).rewrite_query(names);
+  }
+
+  /// Returns this URL without the query parameters whose decoded names
+  /// match a set of names or prefixes
+  ///
+  /// \param names The names of the parameters to remove
+  /// \returns A new URL object with the rewritten query
+  [[nodiscard]] auto rewrite_query(const query_name_set& names) && -> url {
+    return std::move(*this).rewrite_query([&names](std::string_view name, std::string_view) {
+      return details::contains_decoded_name(names, name) ? query_rewrite::drop() : query_rewrite::keep();
+    });
+  }
+
   // Immutable transformation methods (with_* methods)
 
   /// Returns a copy of this URL with the scheme changed
@@ -1197,24 +1485,28 @@ class url {
   ///
   /// \returns `href_.c_str()`
   [[nodiscard]] auto c_str() const noexcept {
-    return href_.c_str();
+    return storage_->href.c_str();
   }
 
   /// Returns the underlying byte buffer
   ///
   /// \returns `href_.data()`
   [[nodiscard]] auto data() const noexcept {
-    return href_.data();
+    return storage_->href.data();
   }
 
   /// Returns the underlying string
   ///
   /// \returns `href_`
   explicit operator string_type() const {
-    return href_;
+    return storage_->href;
   }
 
  private:
+  [[nodiscard]] auto component_view(std::size_t first, std::size_t last) const noexcept -> string_view {
+    return string_view(storage_->href).substr(first, last - first);
+  }
+
   void initialize(string_view input, const url_record* base) {
     using result_type = std::expected<void, url_parse_errc>;
 
@@ -1234,17 +1526,60 @@ class url {
     initialize(input, nullptr);
   }
 
+  [[nodiscard]] auto share_storage() const -> details::url_storage_ptr {
+    if (storage_->is_shareable) {
+      return storage_;
+    }
+    auto storage = details::url_storage_ptr(new details::url_storage(*storage_));
+    storage->is_shareable = true;
+    storage->parameters.url_ = nullptr;
+    return storage;
+  }
+
+  /// Points the search parameters back at this object after the storage was moved, if a reference to them escaped
+  void adopt_search_parameters() noexcept {
+    if (!storage_->is_shareable) {
+      storage_->parameters.url_ = this;
+    }
+  }
+
+  auto mutable_storage() -> details::url_storage& {
+    if (!storage_.is_unique()) {
+      storage_ = details::url_storage_ptr(new details::url_storage(*storage_));
+    }
+    return *storage_;
+  }
+
   void update_record(url_record&& url) {
-    url_ = std::move(url);
-    href_ = serialize(url_);
-    view_ = string_view(href_);
-    parameters_.initialize(url_.query ? string_view(url_.query.value()) : string_view{});
+    if (!storage_.is_unique()) {
+      storage_ = details::url_storage_ptr(new details::url_storage());
+    }
+    storage_->record = std::move(url);
+    refresh_storage();
   }
 
-  url_record url_;
-  std::string href_;
-  string_view view_;
-  url_search_parameters parameters_;
+  url(url_record&& record, std::string&& href) : storage_(new details::url_storage()) {
+    storage_->record = std::move(record);
+    storage_->href = std::move(href);
+    index_storage();
+  }
+
+  void refresh_storage() {
+    storage_->href = serialize(storage_->record);
+    index_storage();
+  }
+
+  void index_storage() {
+    auto& storage = *storage_;
+    storage.offsets = details::make_component_offsets(storage.record, storage.href);
+    storage.parameters.parameters_.clear();
+    if (storage.record.query) {
+      storage.parameters.initialize(storage.record.query.value());
+    }
+    storage.parameters.index();
+  }
+
+  details::url_storage_ptr storage_;
 };
 
 /// Swaps two `url` objects
@@ -1353,6 +1688,97 @@ inline auto operator>=(const url& lhs, const url& rhs) noexcept {
   return !(lhs < rhs);
 }
 
+/// Hashes a URL by its serialization, consistently with `operator==`
+///
+/// The hash is transparent, so together with `url_equal` an unordered
+/// container of URLs can be searched with a serialized URL string without
+/// constructing a `url`:
+///
+/// \code
+/// auto urls = std::unordered_set<skyr::url, skyr::url_hash, skyr::url_equal>{};
+/// urls.contains(std::string_view("https://example.com/"));
+/// \endcode
+///
+/// The string must already be serialized (e.g. a previous `href()`);
+/// it is not parsed or normalized.
+struct url_hash {
+  /// Enables heterogeneous lookup
+  using is_transparent = void;
+
+  /// \param value A URL
+  /// \returns The hash of the URL's serialization
+  auto operator()(const url& value) const noexcept -> std::size_t {
+    return (*this)(value.href_view());
+  }
+
+  /// \param href A serialized URL
+  /// \returns The hash of the serialization
+  auto operator()(std::string_view href) const noexcept -> std::size_t {
+    return std::hash<std::string_view>{}(href);
+  }
+};
+
+/// Compares URLs and serialized URL strings, for heterogeneous lookup
+/// in unordered containers
+/// \sa url_hash
+struct url_equal {
+  /// Enables heterogeneous lookup
+  using is_transparent = void;
+
+  auto operator()(const url& lhs, const url& rhs) const noexcept -> bool {
+    return lhs.href_view() == rhs.href_view();
+  }
+
+  auto operator()(const url& lhs, std::string_view rhs) const noexcept -> bool {
+    return lhs.href_view() == rhs;
+  }
+
+  auto operator()(std::string_view lhs, const url& rhs) const noexcept -> bool {
+    return lhs == rhs.href_view();
+  }
+};
+
+/// Hashes only the hostname of a URL, e.g. to group URLs by host
+struct url_host_hash {
+  /// \param value A URL
+  /// \returns The hash of the serialized hostname
+  auto operator()(const url& value) const noexcept -> std::size_t {
+    return std::hash<std::string_view>{}(value.hostname_view());
+  }
+};
+
+/// Hashes only the origin of a URL, e.g. to group URLs by origin
+///
+/// URLs with the same tuple origin have the same hash. An opaque origin is
+/// only equal to itself, so URLs with an opaque origin are hashed by their
+/// serialization instead, which keeps the hash deterministic and consistent
+/// with `url_equal`.
+struct url_origin_hash {
+  /// \param value A URL
+  /// \returns The hash of the URL's origin, or of its serialization if the
+  ///          origin is opaque
+  auto operator()(const url& value) const -> std::size_t {
+    auto result = origin(value);
+    if (result.is_opaque()) {
+      return details::hash_combine(~std::size_t{0}, std::hash<std::string_view>{}(value.href_view()));
+    }
+    return result.hash();
+  }
+};
+
+/// Hashes a URL without its fragment, e.g. to deduplicate URLs that only
+/// differ in their fragment
+struct url_without_fragment_hash {
+  /// \param value A URL
+  /// \returns The hash of the serialization up to, but not including, the fragment
+  auto operator()(const url& value) const noexcept -> std::size_t {
+    const auto& fragment = value.record().fragment;
+    auto href = value.href_view();
+    href.remove_suffix(fragment ? fragment.value().size() + 1 : 0);
+    return std::hash<std::string_view>{}(href);
+  }
+};
+
 ///
 /// \param os
 /// \param url
@@ -1395,21 +1821,56 @@ inline auto operator""_url(const char32_t* str, std::size_t length) {
 }
 }  // namespace literals
 
-inline url_search_parameters::url_search_parameters(url* url) : url_(url) {
-  if (url_->record().query) {
-    initialize(url_->record().query.value());
-  }
-}
-
 inline void url_search_parameters::update() {
   if (url_) {
     auto query = to_string();
     parameters_.clear();
-    url_->set_search(std::string_view(query));
+    index();
+    url_->set_search(std::move(query));
+  } else {
+    index();
   }
 }
+
+inline origin::origin(const url& url) {
+  const auto& record = url.storage_->record;
+  if (record.scheme == "blob") {
+    *this = origin(record);
+    return;
+  }
+
+  auto scheme = details::to_origin_scheme(record.scheme);
+  if (!scheme || !record.host) {
+    opaque_id_ = details::next_opaque_origin_id();
+    return;
+  }
+
+  // Borrow the domain from the URL's href, unless the storage may still be
+  // modified through an escaped search_parameters() reference
+  auto domain = url.hostname_view();
+  if (!record.host.value().is_domain_name()) {
+    domain = {};
+  } else if (url.storage_->is_shareable) {
+    storage_ = url.storage_;
+  } else {
+    name_ = std::make_shared<const std::string>(domain);
+    domain = *name_;
+  }
+  set_tuple(scheme.value(), record.host.value(), record.port, domain);
+}
 }  // namespace skyr
 
+namespace std {
+/// Hashes a skyr::url by its serialization, so that URLs can be used as
+/// keys in unordered containers
+template <>
+struct hash<skyr::url> {
+  auto operator()(const skyr::url& url) const noexcept -> std::size_t {
+    return skyr::url_hash{}(url);
+  }
+};
+}  // namespace std
+
 #if defined(SKYR_PLATFORM_MSVC)
 #  pragma warning(pop)
 #endif  // defined(SKYR_PLATFORM_MSVC)
@@ -0,0 +1,626 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SKYR_URL_BUILDER_HPP
+#define SKYR_URL_BUILDER_HPP
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <locale>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <skyr/core/errors.hpp>
+#include <skyr/core/host.hpp>
+#include <skyr/core/schemes.hpp>
+#include <skyr/core/url_record.hpp>
+#include <skyr/percent_encoding/byte_set.hpp>
+#include <skyr/percent_encoding/percent_encode.hpp>
+#include <skyr/percent_encoding/percent_encoded_char.hpp>
+#include <skyr/url.hpp>
+
+/// \file url_builder.hpp
+/// Provides skyr::url_builder, which applies several component edits and
+/// serializes the result once
+///
+/// Example:
+/// \code
+/// auto result = skyr::url_builder()
+///     .set_scheme("https")
+///     .set_hostname("example.com")
+///     .append_path_segment("search")
+///     .append_parameter("q", "a b")
+///     .build();
+/// // result.value().href() == "https://example.com/search?q=a%20b"
+/// \endcode
+
+namespace skyr {
+namespace details {
+/// A component held by a url_builder. Strings moved into the builder are
+/// owned, anything else is borrowed and must outlive the call to build.
+class url_builder_component {
+ public:
+  url_builder_component() = default;
+
+  /// Borrows a string
+  /// \param value A string view
+  explicit url_builder_component(std::string_view value) noexcept : value_(value) {
+  }
+
+  /// Takes ownership of a string
+  /// \param value A string
+  template <class String>
+    requires std::same_as<String, std::string>
+  explicit url_builder_component(String&& value) : value_(std::move(value)) {
+  }
+
+  /// \returns The component value
+  [[nodiscard]] auto view() const noexcept -> std::string_view {
+    return std::visit([](const auto& value) { return std::string_view(value); }, value_);
+  }
+
+  /// Removes a leading delimiter, such as the '?' before a query
+  /// \param delimiter The delimiter
+  void remove_prefix(char delimiter) {
+    if (view().starts_with(delimiter)) {
+      if (auto borrowed = std::get_if<std::string_view>(&value_)) {
+        borrowed->remove_prefix(1);
+      } else {
+        std::get<std::string>(value_).erase(0, 1);
+      }
+    }
+  }
+
+ private:
+  std::variant<std::string_view, std::string> value_;
+};
+
+/// Any string type that a url_builder can borrow or own
+template <class Source>
+concept is_url_builder_source = std::convertible_to<Source, std::string_view>;
+
+/// Appends `input` to `output`, percent encoding the bytes in a set
+/// \param output The output string, which should already have enough capacity
+/// \param input An unencoded string
+/// \param bytes The bytes that must be encoded
+inline void percent_encode_to(std::string& output, std::string_view input, const percent_encoding::byte_set& bytes) {
+  constexpr auto mask = std::byte(0x0f);
+  auto first = input.data(), last = input.data() + input.size();
+  while (first != last) {
+    auto encoded = percent_encoding::details::find_first_of(bytes, first, last);
+    output.append(first, encoded);
+    if (encoded == last) {
+      break;
+    }
+
+    auto byte = static_cast<std::byte>(*encoded);
+    output.push_back('%');
+    output.push_back(percent_encoding::details::hex_to_alnum((byte >> 4u) & mask));
+    output.push_back(percent_encoding::details::hex_to_alnum(byte & mask));
+    first = encoded + 1;
+  }
+}
+
+/// The bytes encoded in a path segment of a non-special URL
+inline constexpr auto segment_bytes = percent_encoding::byte_set::from_predicate([](std::byte byte) {
+  return percent_encoding::details::is_path_byte(byte) || (byte == std::byte('/'));
+});
+
+/// The bytes encoded in a path segment of a special URL
+inline constexpr auto special_segment_bytes = percent_encoding::byte_set::from_predicate([](std::byte byte) {
+  return percent_encoding::details::is_path_byte(byte) || (byte == std::byte('/')) || (byte == std::byte('\\'));
+});
+
+/// \param segment A path segment
+/// \returns `true` if the segment is "." or its percent encoded equivalent
+inline auto is_single_dot_segment(std::string_view segment) noexcept -> bool {
+  return (segment == ".") || (segment == "%2e") || (segment == "%2E");
+}
+
+/// \param segment A path segment
+/// \returns `true` if the segment is ".." or its percent encoded equivalent
+inline auto is_double_dot_segment(std::string_view segment) noexcept -> bool {
+  if (segment.size() == 2) {
+    return segment == "..";
+  }
+  if (segment.size() == 4) {
+    return (segment.starts_with('.') && is_single_dot_segment(segment.substr(1))) ||
+           (segment.ends_with('.') && is_single_dot_segment(segment.substr(0, 3)));
+  }
+  if (segment.size() == 6) {
+    return is_single_dot_segment(segment.substr(0, 3)) && is_single_dot_segment(segment.substr(3));
+  }
+  return false;
+}
+}  // namespace details
+
+/// Builds a URL from individual components.
+///
+/// Each setter on `skyr::url` serializes the whole URL again, so applying
+/// several edits costs several serializations. A `url_builder` collects the
+/// edits, then validates and percent encodes each component once while writing
+/// the serialized URL into a single, exactly sized buffer.
+///
+/// Components passed as an rvalue `std::string` are moved into the builder.
+/// Any other string argument is borrowed and must outlive the call to `build`.
+/// The first invalid edit is remembered and returned by `build`.
+class url_builder {
+ public:
+  /// Constructs an empty builder
+  url_builder() = default;
+
+  /// Constructs a builder that starts from the components of an existing URL
+  /// \param base A URL
+  explicit url_builder(const url& base) : base_(base) {
+    const auto& record = base_.record();
+    scheme_ = record.scheme;
+    username_ = details::url_builder_component(std::string_view(record.username));
+    password_ = details::url_builder_component(std::string_view(record.password));
+    use_base_host_ = record.host.has_value();
+    port_ = record.port;
+    opaque_path_ = record.cannot_be_a_base_url;
+    path_.reserve(record.path.size());
+    for (const auto& segment : record.path) {
+      path_.emplace_back(std::string_view(segment));
+    }
+    if (record.query) {
+      query_ = details::url_builder_component(std::string_view(record.query.value()));
+    }
+    if (record.fragment) {
+      fragment_ = details::url_builder_component(std::string_view(record.fragment.value()));
+    }
+  }
+
+  /// Sets the URL scheme, e.g. "https"
+  /// \param scheme The scheme, with or without a trailing ':'
+  /// \returns A reference to this builder
+  auto set_scheme(std::string_view scheme) -> url_builder& {
+    if (scheme.ends_with(':')) {
+      scheme.remove_suffix(1);
+    }
+
+    auto is_valid = !scheme.empty() && std::isalpha(scheme.front(), std::locale::classic());
+    for (auto c : scheme) {
+      is_valid = is_valid && (std::isalnum(c, std::locale::classic()) || (c == '+') || (c == '-') || (c == '.'));
+    }
+    if (!is_valid) {
+      return fail(url_parse_errc::invalid_scheme_character);
+    }
+
+    scheme_.assign(scheme);
+    for (auto& c : scheme_) {
+      c = std::tolower(c, std::locale::classic());
+    }
+    return *this;
+  }
+
+  /// Sets the URL username, which is percent encoded when the URL is built
+  /// \param username The username
+  /// \returns A reference to this builder
+  template <class Source>
+    requires details::is_url_builder_source<Source>
+  auto set_username(Source&& username) -> url_builder& {
+    username_ = details::url_builder_component(std::forward<Source>(username));
+    return *this;
+  }
+
+  /// Sets the URL password, which is percent encoded when the URL is built
+  /// \param password The password
+  /// \returns A reference to this builder
+  template <class Source>
+    requires details::is_url_builder_source<Source>
+  auto set_password(Source&& password) -> url_builder& {
+    password_ = details::url_builder_component(std::forward<Source>(password));
+    return *this;
+  }
+
+  /// Sets the URL hostname, which is parsed when the URL is built
+  /// \param hostname The hostname, without a port
+  /// \returns A reference to this builder
+  template <class Source>
+    requires details::is_url_builder_source<Source>
+  auto set_hostname(Source&& hostname) -> url_builder& {
+    hostname_ = details::url_builder_component(std::forward<Source>(hostname));
+    use_base_host_ = false;
+    return *this;
+  }
+
+  /// Removes the URL host
+  /// \returns A reference to this builder
+  auto clear_hostname() -> url_builder& {
+    hostname_.reset();
+    use_base_host_ = false;
+    return *this;
+  }
+
+  /// Sets the URL port. A port equal to the scheme's default port is omitted.
+  /// \param port The port
+  /// \returns A reference to this builder
+  auto set_port(std::uint16_t port) -> url_builder& {
+    port_ = port;
+    return *this;
+  }
+
+  /// Sets the URL port from a string
+  /// \param port The port
+  /// \returns A reference to this builder
+  auto set_port(std::string_view port) -> url_builder& {
+    if (port.empty()) {
+      return clear_port();
+    }
+
+    auto value = std::uint16_t{};
+    auto [last, ec] = std::from_chars(port.data(), port.data() + port.size(), value);
+    if ((ec != std::errc{}) || (last != port.data() + port.size())) {
+      return fail(url_parse_errc::invalid_port);
+    }
+    return set_port(value);
+  }
+
+  /// Removes the URL port
+  /// \returns A reference to this builder
+  auto clear_port() -> url_builder& {
+    port_.reset();
+    return *this;
+  }
+
+  /// Removes all path segments
+  /// \returns A reference to this builder
+  auto clear_path() -> url_builder& {
+    if (opaque_path_) {
+      return fail(url_parse_errc::cannot_be_a_base_url);
+    }
+    path_.clear();
+    return *this;
+  }
+
+  /// Appends a segment to the URL path. The segment is percent encoded when
+  /// the URL is built, including any '/'. A "." segment is ignored and a ".."
+  /// segment removes the last segment.
+  /// \param segment The path segment
+  /// \returns A reference to this builder
+  template <class Source>
+    requires details::is_url_builder_source<Source>
+  auto append_path_segment(Source&& segment) -> url_builder& {
+    if (opaque_path_) {
+      return fail(url_parse_errc::cannot_be_a_base_url);
+    }
+
+    auto value = std::string_view(segment);
+    if (details::is_double_dot_segment(value)) {
+      if (!path_.empty()) {
+        path_.pop_back();
+      }
+    } else if (!details::is_single_dot_segment(value)) {
+      path_.emplace_back(std::forward<Source>(segment));
+    }
+    return *this;
+  }
+
+  /// Sets the URL query, replacing any parameters that have been appended
+  /// \param search The query, with or without a leading '?'
+  /// \returns A reference to this builder
+  template <class Source>
+    requires details::is_url_builder_source<Source>
+  auto set_search(Source&& search) -> url_builder& {
+    query_ = details::url_builder_component(std::forward<Source>(search));
+    query_->remove_prefix('?');
+    parameters_.clear();
+    return *this;
+  }
+
+  /// Removes the URL query and any parameters that have been appended
+  /// \returns A reference to this builder
+  auto clear_search() -> url_builder& {
+    query_.reset();
+    parameters_.clear();
+    return *this;
+  }
+
+  /// Appends a name-value pair to the URL query. Both are percent encoded
+  /// when the URL is built, as with `url_search_parameters`.
+  /// \param name The parameter name
+  /// \param value The parameter value
+  /// \returns A reference to this builder
+  template <class Name, class Value>
+    requires details::is_url_builder_source<Name> && details::is_url_builder_source<Value>
+  auto append_parameter(Name&& name, Value&& value) -> url_builder& {
+    if (!query_) {
+      query_ = details::url_builder_component();
+    }
+    parameters_.emplace_back(details::url_builder_component(std::forward<Name>(name)),
+                             details::url_builder_component(std::forward<Value>(value)));
+    return *this;
+  }
+
+  /// Sets the URL fragment, which is percent encoded when the URL is built
+  /// \param hash The fragment, with or without a leading '#'
+  /// \returns A reference to this builder
+  template <class Source>
+    requires details::is_url_builder_source<Source>
+  auto set_hash(Source&& hash) -> url_builder& {
+    fragment_ = details::url_builder_component(std::forward<Source>(hash));
+    fragment_->remove_prefix('#');
+    return *this;
+  }
+
+  /// Removes the URL fragment
+  /// \returns A reference to this builder
+  auto clear_hash() -> url_builder& {
+    fragment_.reset();
+    return *this;
+  }
+
+  /// Serializes the URL without constructing a `url`
+  /// \returns The serialized URL or an error
+  [[nodiscard]] auto build_href() const -> std::expected<std::string, url_parse_errc> {
+    return serialize_components(nullptr);
+  }
+
+  /// Builds a URL record
+  /// \returns The URL record or an error
+  [[nodiscard]] auto build_record() const -> std::expected<url_record, url_parse_errc> {
+    auto record = url_record{};
+    auto href = serialize_components(&record);
+    if (!href) {
+      return std::unexpected(href.error());
+    }
+    return record;
+  }
+
+  /// Builds a URL. The serialized string is reused as the URL's href.
+  /// \returns The URL or an error
+  [[nodiscard]] auto build() const -> std::expected<url, url_parse_errc> {
+    auto record = url_record{};
+    auto href = serialize_components(&record);
+    if (!href) {
+      return std::unexpected(href.error());
+    }
+    return url(std::move(record), std::move(href).value());
+  }
+
+ private:
+  auto fail(url_parse_errc error) -> url_builder& {
+    if (!error_) {
+      error_ = error;
+    }
+    return *this;
+  }
+
+  auto serialize_components(url_record* record) const -> std::expected<std::string, url_parse_errc> {
+    using percent_encoding::details::c0_control_bytes;
+    using percent_encoding::details::component_bytes;
+    using percent_encoding::details::fragment_bytes;
+    using percent_encoding::details::userinfo_bytes;
+
+    if (error_) {
+      return std::unexpected(error_.value());
+    }
+
+    if (scheme_.empty()) {
+      return std::unexpected(url_parse_errc::invalid_scheme_character);
+    }
+
+    const auto special = is_special(scheme_);
+    const auto is_file = (scheme_ == "file");
+
+    auto parsed_host = std::optional<host>{};
+    if (hostname_ && is_file && hostname_->view().empty()) {
+      parsed_host = host{empty_host{}};
+    } else if (hostname_) {
+      auto result = parse_host(hostname_->view(), !special);
+      if (!result) {
+        return std::unexpected(result.error());
+      }
+      parsed_host = std::move(result).value();
+    } else if (is_file && !use_base_host_) {
+      parsed_host = host{empty_host{}};
+    }
+
+    auto serialized_host = std::string{};
+    auto hostname = std::string_view{};
+    if (parsed_host) {
+      serialized_host = parsed_host->serialize();
+      if (is_file && (serialized_host == "localhost")) {
+        parsed_host = host{empty_host{}};
+        serialized_host.clear();
+      }
+      hostname = serialized_host;
+    } else if (use_base_host_) {
+      hostname = base_.hostname_view();
+    }
+
+    const auto has_host = parsed_host.has_value() || use_base_host_;
+    if (special && !is_file && (!has_host || hostname.empty())) {
+      return std::unexpected(url_parse_errc::empty_hostname);
+    }
+
+    auto username = username_.view();
+    auto password = password_.view();
+    auto has_credentials = !username.empty() || !password.empty();
+    auto port = (port_ == default_port(scheme_)) ? std::nullopt : port_;
+    if ((has_credentials || port) && (!has_host || hostname.empty() || is_file)) {
+      return std::unexpected(url_parse_errc::cannot_have_a_username_password_or_port);
+    }
+
+    auto port_buffer = std::array<char, 5>{};
+    auto port_size = std::size_t{0};
+    if (port) {
+      auto [last, ec] = std::to_chars(port_buffer.data(), port_buffer.data() + port_buffer.size(), port.value());
+      port_size = static_cast<std::size_t>(last - port_buffer.data());
+    }
+
+    const auto& segment_bytes = special ? details::special_segment_bytes : details::segment_bytes;
+    const auto& search_bytes =
+        special ? percent_encoding::details::special_query_bytes : percent_encoding::details::query_bytes;
+    auto implicit_root = !opaque_path_ && special && path_.empty();
+    // Without a host, a path starting with an empty segment would be read back as an authority
+    auto dot_prefix = !opaque_path_ && !has_host && (path_.size() > 1) && path_.front().view().empty();
+
+    // Measure the serialized URL so that it can be written without reallocating
+    auto size = scheme_.size() + 1;
+    if (has_host) {
+      size += 2 + hostname.size();
+      if (has_credentials) {
+        size += percent_encoding::details::percent_encoded_size(username, userinfo_bytes) + 1;
+        if (!password.empty()) {
+          size += percent_encoding::details::percent_encoded_size(password, userinfo_bytes) + 1;
+        }
+      }
+      if (port) {
+        size += port_size + 1;
+      }
+    }
+    if (opaque_path_) {
+      size += percent_encoding::details::percent_encoded_size(path_.front().view(), c0_control_bytes);
+    } else {
+      size += (implicit_root ? 1 : 0) + (dot_prefix ? 2 : 0);
+      for (const auto& segment : path_) {
+        size += percent_encoding::details::percent_encoded_size(segment.view(), segment_bytes) + 1;
+      }
+    }
+    if (query_) {
+      size += percent_encoding::details::percent_encoded_size(query_->view(), search_bytes) + 1;
+      auto separator = !query_->view().empty();
+      for (const auto& [name, value] : parameters_) {
+        size += percent_encoding::details::percent_encoded_size(name.view(), component_bytes) +
+                percent_encoding::details::percent_encoded_size(value.view(), component_bytes) + (separator ? 2 : 1);
+        separator = true;
+      }
+    }
+    if (fragment_) {
+      size += percent_encoding::details::percent_encoded_size(fragment_->view(), fragment_bytes) + 1;
+    }
+
+    auto href = std::string{};
+    href.reserve(size);
+
+    href.append(scheme_);
+    href.push_back(':');
+
+    auto username_range = std::pair<std::size_t, std::size_t>{};
+    auto password_range = std::pair<std::size_t, std::size_t>{};
+    if (has_host) {
+      href.append("//");
+      if (has_credentials) {
+        username_range.first = href.size();
+        details::percent_encode_to(href, username, userinfo_bytes);
+        username_range.second = href.size();
+        if (!password.empty()) {
+          href.push_back(':');
+          password_range.first = href.size();
+          details::percent_encode_to(href, password, userinfo_bytes);
+          password_range.second = href.size();
+        }
+        href.push_back('@');
+      }
+      href.append(hostname);
+      if (port) {
+        href.push_back(':');
+        href.append(port_buffer.data(), port_size);
+      }
+    }
+
+    if (dot_prefix) {
+      href.append("/.");
+    }
+    auto path_begin = href.size();
+    if (opaque_path_) {
+      details::percent_encode_to(href, path_.front().view(), c0_control_bytes);
+    } else {
+      if (implicit_root) {
+        href.push_back('/');
+      }
+      for (const auto& segment : path_) {
+        href.push_back('/');
+        details::percent_encode_to(href, segment.view(), segment_bytes);
+      }
+    }
+    auto path_end = href.size();
+
+    auto query_begin = href.size();
+    if (query_) {
+      href.push_back('?');
+      details::percent_encode_to(href, query_->view(), search_bytes);
+      auto separator = !query_->view().empty();
+      for (const auto& [name, value] : parameters_) {
+        if (separator) {
+          href.push_back('&');
+        }
+        details::percent_encode_to(href, name.view(), component_bytes);
+        href.push_back('=');
+        details::percent_encode_to(href, value.view(), component_bytes);
+        separator = true;
+      }
+    }
+    auto query_end = href.size();
+
+    if (fragment_) {
+      href.push_back('#');
+      details::percent_encode_to(href, fragment_->view(), fragment_bytes);
+    }
+
+    if (record != nullptr) {
+      auto substr = [&href](auto first, auto last) { return href.substr(first, last - first); };
+
+      record->scheme = scheme_;
+      record->username = substr(username_range.first, username_range.second);
+      record->password = substr(password_range.first, password_range.second);
+      if (parsed_host) {
+        record->host = std::move(parsed_host);
+      } else if (use_base_host_) {
+        record->host = base_.record().host;
+      }
+      record->port = port;
+      record->cannot_be_a_base_url = opaque_path_;
+      record->path.clear();
+      if (opaque_path_) {
+        record->path.emplace_back(substr(path_begin, path_end));
+      } else {
+        record->path.reserve(path_.size() + (implicit_root ? 1 : 0));
+        auto first = path_begin + 1;
+        while (first <= path_end) {
+          auto last = href.find('/', first);
+          last = ((last == std::string::npos) || (last > path_end)) ? path_end : last;
+          record->path.emplace_back(substr(first, last));
+          first = last + 1;
+        }
+      }
+      if (query_) {
+        record->query = substr(query_begin + 1, query_end);
+      }
+      if (fragment_) {
+        record->fragment = href.substr(query_end + 1);
+      }
+    }
+
+    return href;
+  }
+
+  url base_;
+  std::string scheme_;
+  details::url_builder_component username_;
+  details::url_builder_component password_;
+  std::optional<details::url_builder_component> hostname_;
+  bool use_base_host_ = false;
+  std::optional<std::uint16_t> port_;
+  bool opaque_path_ = false;
+  std::vector<details::url_builder_component> path_;
+  std::optional<details::url_builder_component> query_;
+  std::vector<std::pair<details::url_builder_component, details::url_builder_component>> parameters_;
+  std::optional<details::url_builder_component> fragment_;
+  std::optional<url_parse_errc> error_;
+};
+}  // namespace skyr
+
+#endif  // SKYR_URL_BUILDER_HPP
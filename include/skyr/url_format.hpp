@@ -6,9 +6,17 @@
 #ifndef SKYR_URL_FORMAT_HPP
 #define SKYR_URL_FORMAT_HPP
 
+#include <array>
+#include <charconv>
+#include <cstddef>
 #include <format>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
-#include <skyr/percent_encoding/percent_decode.hpp>
+#include <skyr/percent_encoding/percent_decode_utf8.hpp>
 #include <skyr/url.hpp>
 
 /// \file url_format.hpp
@@ -28,8 +36,19 @@
 /// - {:fd}      - Fragment (percent-decoded)
 /// - {:o}       - Origin (scheme://host:port)
 ///
-/// The 'd' modifier decodes percent-encoding and punycode.
-/// If decoding fails, falls back to the encoded version.
+/// The 'd' modifier decodes percent-encoding and punycode. If punycode
+/// decoding fails, falls back to the encoded version. Percent-decoded
+/// bytes that are not valid UTF-8 are replaced with U+FFFD.
+///
+/// A fill character, alignment and width may precede the type, as for
+/// strings, e.g. `{:>30h}`, `{:*^40Pd}` or `{:>{}P}`. Encoded and decoded
+/// output are padded the same way, by the width of the text written.
+///
+/// Components are copied directly from the URL's serialized string to the
+/// output, and percent-decoded output is decoded and validated in one pass
+/// by `percent_decode_utf8_to`, so only `{:hd}` and `{:o}` build an
+/// intermediate string. Padded percent-decoded output is decoded into a
+/// buffer first, which is on the stack unless the component is long.
 ///
 /// Examples:
 /// \code
@@ -58,8 +77,15 @@ struct formatter<skyr::url> {
 
   format_type type_ = format_type::full;
   bool decode_ = false;  // 'd' modifier for decoded output
+  char fill_ = ' ';
+  char align_ = '<';
+  std::size_t width_ = 0;
+  std::optional<std::size_t> width_arg_id_;       // The argument that gives the width, for {:{}} or {:{n}}
+  formatter<std::string_view> string_formatter_;  // Writes components, with fill, align and a static width
 
   constexpr auto parse(std::format_parse_context& ctx) -> std::format_parse_context::iterator {
+    constexpr auto is_align = [](char c) { return (c == '<') || (c == '>') || (c == '^'); };
+
     auto it = ctx.begin();
     const auto end = ctx.end();
 
@@ -69,6 +95,49 @@ struct formatter<skyr::url> {
       return it;
     }
 
+    // Parse [[fill]align][width]
+    if ((std::next(it) != end) && is_align(*std::next(it)) && (*it != '{') && (*it != '}')) {
+      fill_ = *it++;
+      align_ = *it++;
+    } else if (is_align(*it)) {
+      align_ = *it++;
+    }
+
+    auto spec_end = it;
+    if (it != end && *it == '{') {
+      // The dynamic width is looked up when formatting, so it isn't passed to `string_formatter_`
+      ++it;
+      if (it != end && *it == '}') {
+        width_arg_id_ = ctx.next_arg_id();
+      } else {
+        auto id = std::size_t{0};
+        auto digits = it;
+        while (it != end && *it >= '0' && *it <= '9') {
+          id = (id * 10) + static_cast<std::size_t>(*it - '0');
+          ++it;
+        }
+        if ((it == digits) || (it == end) || (*it != '}')) {
+          throw std::format_error("Invalid width for skyr::url");
+        }
+        ctx.check_arg_id(id);
+        width_arg_id_ = id;
+      }
+      ++it;
+    } else {
+      while (it != end && *it >= '0' && *it <= '9') {
+        width_ = (width_ * 10) + static_cast<std::size_t>(*it - '0');
+        ++it;
+      }
+      spec_end = it;
+    }
+
+    auto string_spec = std::format_parse_context(std::string_view(ctx.begin(), spec_end));
+    string_formatter_.parse(string_spec);
+
+    if (it == end || *it == '}') {
+      return it;
+    }
+
     // Parse format spec
     switch (*it) {
       case 's':
@@ -116,68 +185,111 @@ struct formatter<skyr::url> {
     return it;
   }
 
-  auto format(const skyr::url& url, std::format_context& ctx) const {
+  auto format(const skyr::url& url, std::format_context& ctx) const -> std::format_context::iterator {
+    if (!width_arg_id_) {
+      return format_component(url, string_formatter_, width_ != 0, ctx);
+    }
+
+    // Parse a string spec with the width that was passed as an argument
+    auto width = dynamic_width(ctx);
+    if (width == 0) {
+      return format_component(url, string_formatter_, false, ctx);
+    }
+    auto spec = std::array<char, 24>{fill_, align_};
+    auto last = std::to_chars(spec.data() + 2, spec.data() + spec.size(), width).ptr;
+    auto string_spec = std::format_parse_context(std::string_view(spec.data(), last));
+    auto string_formatter = formatter<std::string_view>{};
+    string_formatter.parse(string_spec);
+    return format_component(url, string_formatter, true, ctx);
+  }
+
+ private:
+  auto dynamic_width(std::format_context& ctx) const -> std::size_t {
+    return std::visit_format_arg(
+        [](auto value) -> std::size_t {
+          using value_type = decltype(value);
+          if constexpr (std::is_integral_v<value_type> && !std::is_same_v<value_type, bool> &&
+                        !std::is_same_v<value_type, char>) {
+            if constexpr (std::is_signed_v<value_type>) {
+              if (value < 0) {
+                throw std::format_error("Negative width for skyr::url");
+              }
+            }
+            return static_cast<std::size_t>(value);
+          } else {
+            throw std::format_error("Width for skyr::url is not an integer");
+          }
+        },
+        ctx.arg(width_arg_id_.value()));
+  }
+
+  auto format_component(const skyr::url& url, const formatter<std::string_view>& string_formatter, bool padded,
+                        std::format_context& ctx) const -> std::format_context::iterator {
+    auto write = [&string_formatter, padded, &ctx](std::string_view value, bool decode) {
+      return write_component(value, decode, string_formatter, padded, ctx);
+    };
+
     switch (type_) {
       case format_type::full:
-        return std::format_to(ctx.out(), "{}", url.href());
+        return write(url.href_view(), false);
 
       case format_type::scheme:
-        return std::format_to(ctx.out(), "{}", url.scheme());
+        return write(url.record().scheme, false);
 
       case format_type::hostname:
         if (decode_) {
           // Try to get unicode domain, fall back to ASCII if not available
           if (auto domain = url.u8domain()) {
-            return std::format_to(ctx.out(), "{}", domain.value());
+            return write(domain.value(), false);
           }
         }
-        return std::format_to(ctx.out(), "{}", url.hostname());
+        return write(url.hostname_view(), false);
 
       case format_type::port:
-        return std::format_to(ctx.out(), "{}", url.port());
+        return write(url.port_view(), false);
 
-      case format_type::pathname: {
-        auto pathname = url.pathname();
-        if (decode_) {
-          // Try to percent-decode, fall back to encoded if decode fails
-          if (auto decoded = skyr::percent_decode(pathname)) {
-            return std::format_to(ctx.out(), "{}", decoded.value());
-          }
-        }
-        return std::format_to(ctx.out(), "{}", pathname);
-      }
+      // The leading '?' or '#' is never percent-encoded, so the whole
+      // component can be decoded
+      case format_type::pathname:
+        return write(url.pathname_view(), decode_);
 
-      case format_type::query: {
-        auto search = url.search();
-        if (decode_ && !search.empty()) {
-          // Decode the query string (skip the leading '?')
-          auto query_part = search.substr(1);  // Remove '?'
-          if (auto decoded = skyr::percent_decode(query_part)) {
-            return std::format_to(ctx.out(), "?{}", decoded.value());
-          }
-        }
-        return std::format_to(ctx.out(), "{}", search);
-      }
+      case format_type::query:
+        return write(url.search_view(), decode_);
 
-      case format_type::fragment: {
-        auto hash = url.hash();
-        if (decode_ && !hash.empty()) {
-          // Decode the fragment (skip the leading '#')
-          auto fragment_part = hash.substr(1);  // Remove '#'
-          if (auto decoded = skyr::percent_decode(fragment_part)) {
-            return std::format_to(ctx.out(), "#{}", decoded.value());
-          }
-        }
-        return std::format_to(ctx.out(), "{}", hash);
-      }
+      case format_type::fragment:
+        return write(url.hash_view(), decode_);
 
       case format_type::origin:
-        return std::format_to(ctx.out(), "{}", url.origin());
+        return write(url.origin(), false);
 
       default:
         return ctx.out();
     }
   }
+
+  static auto write_component(std::string_view value, bool decode, const formatter<std::string_view>& string_formatter,
+                              bool padded, std::format_context& ctx) -> std::format_context::iterator {
+    if (!decode || (value.find('%') == std::string_view::npos)) {
+      return string_formatter.format(value, ctx);
+    }
+
+    // Invalid UTF-8 is replaced with U+FFFD, so that log lines are always valid UTF-8
+    if (!padded) {
+      return skyr::percent_decode_utf8_to(ctx.out(), value).value().out;
+    }
+
+    // Each input byte decodes to at most three bytes (U+FFFD), so short components fit in the buffer
+    auto buffer = std::array<char, 512>{};
+    if (value.size() <= (buffer.size() / 3)) {
+      auto last = skyr::percent_decode_utf8_to(buffer.data(), value).value().out;
+      return string_formatter.format(std::string_view(buffer.data(), last), ctx);
+    }
+
+    auto decoded = std::string{};
+    decoded.reserve(value.size());
+    skyr::percent_decode_utf8_to(std::back_inserter(decoded), value);
+    return string_formatter.format(decoded, ctx);
+  }
 };
 }  // namespace std
 
@@ -7,15 +7,25 @@
 #define SKYR_URL_SEARCH_PARAMETERS_HPP
 
 #include <algorithm>
+#include <bit>
 #include <cassert>
-#include <format>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <ranges>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <skyr/core/parse_query.hpp>
+#include <skyr/core/query_value.hpp>
 #include <skyr/percent_encoding/percent_decode.hpp>
 #include <skyr/percent_encoding/percent_encode.hpp>
 
@@ -33,13 +43,117 @@ struct is_name {
 
   std::string_view name_;
 };
+
+/// The position used to mark the end of a chain of parameters
+inline constexpr auto no_parameter = std::numeric_limits<std::uint32_t>::max();
 }  // namespace details
 
+/// An iterator through the values of the search parameters that have
+/// the same name, in the order they appear in the query
+class search_parameter_value_iterator {
+ public:
+  /// \c std::forward_iterator_tag
+  using iterator_category = std::forward_iterator_tag;
+  /// \c std::string_view
+  using value_type = std::string_view;
+  /// \c std::ptrdiff_t
+  using difference_type = std::ptrdiff_t;
+  /// \c std::string_view
+  using reference = std::string_view;
+
+  /// Constructs an end iterator
+  search_parameter_value_iterator() = default;
+
+  /// \param parameters The search parameters
+  /// \param next The position of the next parameter with the same name,
+  ///        for each parameter, or `nullptr` if there is no index
+  /// \param position The position of the first parameter with the name
+  search_parameter_value_iterator(const std::vector<query_parameter>* parameters,
+                                  const std::vector<std::uint32_t>* next, std::uint32_t position) noexcept
+      : parameters_(parameters), next_(next), position_(position) {
+  }
+
+  /// \returns The parameter value, or an empty string if it has no value
+  [[nodiscard]] auto operator*() const noexcept -> reference {
+    const auto& value = (*parameters_)[position_].value;
+    return value ? std::string_view(value.value()) : std::string_view();
+  }
+
+  /// Moves to the next parameter with the same name
+  auto operator++() noexcept -> search_parameter_value_iterator& {
+    if (next_ != nullptr) {
+      position_ = (*next_)[position_];
+    } else {
+      // The name is that of the current parameter, so the iterator
+      // doesn't refer to the name that was passed to `get_all`
+      auto first = std::next(parameters_->begin(), position_ + 1), last = parameters_->end();
+      auto it = std::find_if(first, last, details::is_name((*parameters_)[position_].name));
+      position_ = (it != last) ? static_cast<std::uint32_t>(it - parameters_->begin()) : details::no_parameter;
+    }
+    return *this;
+  }
+
+  /// Moves to the next parameter with the same name
+  auto operator++(int) noexcept -> search_parameter_value_iterator {
+    auto previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  /// \returns `true` if both iterators are at the same parameter
+  friend auto operator==(const search_parameter_value_iterator& lhs,
+                         const search_parameter_value_iterator& rhs) noexcept -> bool {
+    return lhs.position_ == rhs.position_;
+  }
+
+  /// \returns `true` if there are no more values
+  friend auto operator==(const search_parameter_value_iterator& it, std::default_sentinel_t) noexcept -> bool {
+    return it.position_ == details::no_parameter;
+  }
+
+ private:
+  const std::vector<query_parameter>* parameters_ = nullptr;
+  const std::vector<std::uint32_t>* next_ = nullptr;
+  std::uint32_t position_ = details::no_parameter;
+};
+
+/// A view of the values of the search parameters that have the same
+/// name. It refers to the search parameters, so it is invalidated
+/// when they are modified.
+class search_parameter_values : public std::ranges::view_interface<search_parameter_values> {
+ public:
+  /// Constructs an empty view
+  search_parameter_values() = default;
+
+  /// \param first An iterator to the first value
+  explicit search_parameter_values(search_parameter_value_iterator first) noexcept : first_(first) {
+  }
+
+  /// \returns An iterator to the first value
+  [[nodiscard]] auto begin() const noexcept {
+    return first_;
+  }
+
+  /// \returns An iterator marking the end of the values
+  [[nodiscard]] auto end() const noexcept {
+    return search_parameter_value_iterator();
+  }
+
+ private:
+  search_parameter_value_iterator first_;
+};
+
 /// Supports iterating through
 /// [URL search parameters](https://url.spec.whatwg.org/#urlsearchparams)
 ///
 /// The API closely follows the
 /// [WhatWG IDL specification](https://url.spec.whatwg.org/#interface-urlsearchparams)
+///
+/// When there are at least `index_threshold` parameters, the names are
+/// indexed in a hash table whenever the parameters change, so that
+/// `get`, `get_all`, `contains` and `set` don't scan every parameter.
+/// The index is never built from a `const` member function, so
+/// parameters shared between threads can be read concurrently.
 class url_search_parameters {
   friend class url;
 
@@ -60,6 +174,9 @@ class url_search_parameters {
   /// \c std::size_t
   using size_type = std::size_t;
 
+  /// The number of parameters at which the names are indexed
+  static constexpr size_type index_threshold = 16;
+
   /// Default constructor
   url_search_parameters() = default;
 
@@ -67,22 +184,27 @@ class url_search_parameters {
   /// \param query The search string
   explicit url_search_parameters(std::string_view query) {
     initialize(query);
+    index();
   }
 
   /// Constructor
   /// \param parameters
   explicit url_search_parameters(std::vector<query_parameter> parameters) : parameters_(std::move(parameters)) {
+    index();
   }
 
   /// Constructor
   /// \param parameters
   url_search_parameters(std::initializer_list<value_type> parameters) : parameters_(parameters) {
+    index();
   }
 
   ///
   /// \param other
   void swap(url_search_parameters& other) noexcept {
     std::swap(parameters_, other.parameters_);
+    std::swap(slots_, other.slots_);
+    std::swap(next_, other.next_);
   }
 
   /// Appends a name-value pair to the search string
@@ -107,25 +229,59 @@ class url_search_parameters {
   /// \param name The search parameter name
   /// \returns The first search parameter value with the given name
   [[nodiscard]] auto get(std::string_view name) const -> std::optional<string_type> {
-    auto first = std::cbegin(parameters_), last = std::cend(parameters_);
-    auto it = std::find_if(first, last, details::is_name(name));
-    return (it != last) ? it->value : std::nullopt;
+    auto position = find_first(name);
+    return (position != details::no_parameter) ? parameters_[position].value : std::nullopt;
+  }
+
+  /// Converts the first search parameter value with the given name,
+  /// without copying it
+  ///
+  /// ```
+  /// auto url = skyr::url("https://example.org/?page=3&debug=true");
+  /// assert(url.search_parameters().get_as<int>("page") == 3);
+  /// assert(url.search_parameters().get_as<bool>("debug") == true);
+  /// ```
+  ///
+  /// \tparam T An integer, floating point, `bool` or enum type
+  /// \param name The search parameter name
+  /// \returns The converted value, or an error
+  /// \sa parse_query_value
+  template <query_value T>
+  [[nodiscard]] auto get_as(std::string_view name) const -> std::expected<T, query_value_errc> {
+    auto position = find_first(name);
+    if (position == details::no_parameter) {
+      return std::unexpected(query_value_errc::not_found);
+    }
+    const auto& value = parameters_[position].value;
+    return parse_query_value<T>(value ? std::string_view(value.value()) : std::string_view());
   }
 
+  /// Converts the first search parameter value with the given name to
+  /// an enum by name
+  ///
+  /// \tparam T An enum type
   /// \param name The search parameter name
-  /// \returns All search parameter values with the given name
-  [[nodiscard]] auto get_all(std::string_view name) const -> std::vector<string_type> {
-    // Count matching parameters first to reserve exact size
-    auto count = std::count_if(parameters_.begin(), parameters_.end(), details::is_name(name));
-
-    std::vector<string_type> result;
-    result.reserve(count);
-    for (auto [parameter_name, value] : parameters_) {
-      if (parameter_name == name) {
-        result.emplace_back(value.value_or(""));
-      }
+  /// \param names The name of each enum value
+  /// \returns The converted value, or an error
+  template <class T>
+    requires std::is_enum_v<T>
+  [[nodiscard]] auto get_as(std::string_view name, std::initializer_list<std::pair<std::string_view, T>> names) const
+      -> std::expected<T, query_value_errc> {
+    auto position = find_first(name);
+    if (position == details::no_parameter) {
+      return std::unexpected(query_value_errc::not_found);
     }
-    return result;
+    const auto& value = parameters_[position].value;
+    return parse_query_value<T>(value ? std::string_view(value.value()) : std::string_view(), names);
+  }
+
+  /// \param name The search parameter name
+  /// \returns A view of all search parameter values with the given
+  ///          name, which refers to these parameters and is
+  ///          invalidated when they are modified
+  [[nodiscard]] auto get_all(std::string_view name) const noexcept -> search_parameter_values {
+    auto next = slots_.empty() ? nullptr : &next_;
+    return search_parameter_values(search_parameter_value_iterator(&parameters_, next, find_first(name)));
   }
 
   /// Tests if there is a parameter with the given name
@@ -134,8 +290,7 @@ class url_search_parameters {
   /// \returns `true` if the value is in the search parameters,
   /// `false` otherwise.
   [[nodiscard]] auto contains(std::string_view name) const noexcept -> bool {
-    auto first = std::cbegin(parameters_), last = std::cend(parameters_);
-    return std::find_if(first, last, details::is_name(name)) != last;
+    return find_first(name) != details::no_parameter;
   }
 
   /// Sets a URL search parameter
@@ -143,9 +298,9 @@ class url_search_parameters {
   /// \param name The search parameter name
   /// \param value The search parameter value
   void set(std::string_view name, std::string_view value) {
-    auto first = std::begin(parameters_), last = std::end(parameters_);
-    auto it = std::find_if(first, last, details::is_name(name));
-    if (it != last) {
+    auto position = find_first(name);
+    if (position != details::no_parameter) {
+      auto it = std::next(std::begin(parameters_), position), last = std::end(parameters_);
       it->value = value;
 
       ++it;
@@ -218,40 +373,102 @@ class url_search_parameters {
   /// \returns The serialized URL search parameters
   [[nodiscard]] auto to_string() const -> string_type {
     auto result = string_type{};
+    result.reserve(serialized_size());
+    serialize_to(std::back_inserter(result));
+    return result;
+  }
 
-    bool start = true;
+  /// Writes the serialized URL search parameters to an output
+  /// iterator, without building intermediate strings
+  ///
+  /// \param out An output iterator
+  /// \returns The output iterator, after the last character written
+  template <std::output_iterator<char> OutputIt>
+  auto serialize_to(OutputIt out) const -> OutputIt {
+    auto start = true;
     for (const auto& [name, value] : parameters_) {
-      if (start) {
-        result.append(percent_encode(name));
-        start = false;
-      } else {
-        result.append(std::format("&{}", percent_encode(name)));
+      if (!start) {
+        *out++ = '&';
       }
+      start = false;
+      out = percent_encode_to(std::move(out), name);
       if (value) {
-        result.append(std::format("={}", percent_encode(value.value())));
+        *out++ = '=';
+        out = percent_encode_to(std::move(out), value.value());
       }
     }
+    return out;
+  }
 
-    return result;
+  /// \returns The exact size of the serialized URL search parameters
+  [[nodiscard]] auto serialized_size() const noexcept -> size_type {
+    auto size = parameters_.empty() ? size_type{0} : parameters_.size() - 1;
+    for (const auto& [name, value] : parameters_) {
+      size += percent_encoded_size(name);
+      if (value) {
+        size += 1 + percent_encoded_size(value.value());
+      }
+    }
+    return size;
   }
 
  private:
-  explicit url_search_parameters(url* url);
-
   void initialize(std::string_view query) {
-    if (auto parameters = parse_query(query); parameters) {
-      for (auto [name, value] : parameters.value()) {
-        auto name_ = percent_decode(name).value_or(std::string(name));
-        auto value_ = value ? percent_decode(value.value()).value_or(std::string(value.value())) : std::string();
-        parameters_.emplace_back(name_, value_);
+    [[maybe_unused]] bool validation_error = false;
+    [[maybe_unused]] auto result = details::visit_query_parameters(query, &validation_error, [this](auto view) {
+      for (auto parameter : view) {
+        parameters_.emplace_back(parameter.decoded_name(), parameter.decoded_value().value_or(std::string()));
       }
-    }
+    });
   }
 
   void update();
 
+  /// Builds the name index, or removes it if there are too few parameters
+  void index() {
+    slots_.clear();
+    next_.clear();
+    if ((parameters_.size() < index_threshold) || (parameters_.size() >= details::no_parameter)) {
+      return;
+    }
+
+    // Insert the parameters in reverse order, so that each slot ends up
+    // holding the first parameter with a name, followed by a chain of
+    // the others in order
+    slots_.assign(std::bit_ceil(parameters_.size() * 2), details::no_parameter);
+    next_.assign(parameters_.size(), details::no_parameter);
+    for (auto position = static_cast<std::uint32_t>(parameters_.size()); position-- > 0;) {
+      auto& slot = slots_[find_slot(parameters_[position].name)];
+      next_[position] = slot;
+      slot = position;
+    }
+  }
+
+  [[nodiscard]] auto find_slot(std::string_view name) const noexcept -> std::size_t {
+    auto mask = slots_.size() - 1;
+    auto slot = std::hash<std::string_view>{}(name) & mask;
+    while ((slots_[slot] != details::no_parameter) && (parameters_[slots_[slot]].name != name)) {
+      slot = (slot + 1) & mask;
+    }
+    return slot;
+  }
+
+  [[nodiscard]] auto find_first(std::string_view name) const noexcept -> std::uint32_t {
+    if (!slots_.empty()) {
+      return slots_[find_slot(name)];
+    }
+    auto first = std::cbegin(parameters_), last = std::cend(parameters_);
+    auto it = std::find_if(first, last, details::is_name(name));
+    return (it != last) ? static_cast<std::uint32_t>(it - first) : details::no_parameter;
+  }
+
   std::vector<value_type> parameters_;
   url* url_ = nullptr;
+
+  // An open addressing hash table of the first position of each name,
+  // and the position of the next parameter with the same name
+  std::vector<std::uint32_t> slots_;
+  std::vector<std::uint32_t> next_;
 };
 
 ///
@@ -0,0 +1,34 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt of copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include "allocations.hpp"
+
+#include <format>
+#include <iostream>
+#include <string>
+
+#include <skyr/core/parse_query.hpp>
+
+int main() {
+  auto query = std::string{};
+  for (auto i = 0; query.size() < 4096; ++i) {
+    query += std::format("{}parameter{}=value%20{}", query.empty() ? "" : "&", i, i);
+  }
+
+  {
+    SKYR_ALLOCATIONS_START_COUNTING("skyr::query_parameters_view::find (" << query.size() << " bytes)");
+    auto parameters = skyr::query_parameters_view(query);
+    auto first = parameters.find("parameter1");
+    auto last = parameters.find("parameter120");
+    if (!first || !last) {
+      return 1;
+    }
+  }
+
+  {
+    SKYR_ALLOCATIONS_START_COUNTING("skyr::parse_query (" << query.size() << " bytes)");
+    auto parameters = skyr::parse_query(query);
+  }
+}
@@ -0,0 +1,98 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/core/form_urlencoded.hpp>
+
+namespace {
+using pairs = std::vector<std::pair<std::string, std::string>>;
+
+auto parse(std::string_view content) -> pairs {
+  auto result = pairs{};
+  skyr::parse_form_urlencoded(content, [&result](std::string_view name, std::string_view value) {
+    result.emplace_back(name, value);
+  });
+  return result;
+}
+
+auto parse_in_chunks(std::string_view content, std::size_t chunk_size) -> pairs {
+  auto result = pairs{};
+  auto callback = [&result](std::string_view name, std::string_view value) { result.emplace_back(name, value); };
+  auto parser = skyr::form_urlencoded_parser();
+  while (!content.empty()) {
+    auto chunk = content.substr(0, chunk_size);
+    content.remove_prefix(chunk.size());
+    parser.feed(chunk, callback);
+  }
+  parser.finish(callback);
+  return result;
+}
+}  // namespace
+
+TEST_CASE("form_urlencoded_tests", "[parse]") {
+  SECTION("parse_pairs") {
+    CHECK(parse("a=1&b=x+y&c=%7E%3d") == pairs{{"a", "1"}, {"b", "x y"}, {"c", "~="}});
+    CHECK(parse("name=J+Smith&city=Z%C3%BCrich") == pairs{{"name", "J Smith"}, {"city", "Z\xc3\xbcrich"}});
+  }
+
+  SECTION("empty_sequences_are_skipped") {
+    CHECK(parse("").empty());
+    CHECK(parse("&&a&=&b=&") == pairs{{"a", ""}, {"", ""}, {"b", ""}});
+  }
+
+  SECTION("only_the_first_equals_separates") {
+    CHECK(parse("a=b=c") == pairs{{"a", "b=c"}});
+  }
+
+  SECTION("invalid_percent_encoding_is_kept") {
+    CHECK(parse("a=%&b=%4&c=%4g&d=%+&e%=1") ==
+          pairs{{"a", "%"}, {"b", "%4"}, {"c", "%4g"}, {"d", "% "}, {"e%", "1"}});
+    CHECK(parse("a=%") == pairs{{"a", "%"}});
+    CHECK(parse("a=%2") == pairs{{"a", "%2"}});
+  }
+
+  SECTION("chunks") {
+    auto content = std::string_view("first=a+b%20c&%E2%9C%93=%25%2&&last=x%3D%3");
+    auto expected = parse(content);
+    CHECK(expected == pairs{{"first", "a b c"}, {"\xe2\x9c\x93", "%%2"}, {"last", "x=%3"}});
+    for (auto chunk_size = std::size_t{1}; chunk_size <= content.size(); ++chunk_size) {
+      CHECK(parse_in_chunks(content, chunk_size) == expected);
+    }
+  }
+
+  SECTION("pairs_are_emitted_when_complete") {
+    auto names = std::vector<std::string>{};
+    auto callback = [&names](std::string_view name, std::string_view) { names.emplace_back(name); };
+    auto parser = skyr::form_urlencoded_parser();
+    parser.feed("a=1&b", callback);
+    CHECK(names == std::vector<std::string>{"a"});
+    parser.feed("=2&", callback);
+    CHECK(names == std::vector<std::string>{"a", "b"});
+    parser.finish(callback);
+    CHECK(names == std::vector<std::string>{"a", "b"});
+  }
+
+  SECTION("serialize") {
+    auto body = std::string{};
+    auto serializer = skyr::form_urlencoded_serializer(std::back_inserter(body));
+    serializer.append("name", "J Smith");
+    serializer.append("city", "Z\xc3\xbcrich");
+    serializer.append("symbols", "*-._~!'()&=+%");
+    CHECK(body == "name=J+Smith&city=Z%C3%BCrich&symbols=*-._%7E%21%27%28%29%26%3D%2B%25");
+    CHECK(skyr::serialize_form_urlencoded(parse(body)) == body);
+  }
+
+  SECTION("serialize_range") {
+    CHECK(skyr::serialize_form_urlencoded(pairs{}).empty());
+    CHECK(skyr::serialize_form_urlencoded(pairs{{"a b", ""}, {"", "c"}}) == "a+b=&=c");
+  }
+}
@@ -4,6 +4,7 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include <exception>
+#include <string>
 #include <string_view>
 #include <variant>
 
@@ -63,4 +64,36 @@ TEST_CASE("parse_host_tests", "url.parse_host") {
       CHECK_NOTHROW(host.value().to_ipv6_address());
     }
   }
+
+  SECTION("ASCII domains") {
+    SECTION("ASCII fast path matches domain_to_ascii") {
+      auto input = GENERATE("example.com"sv, "EXAMPLE.COM"sv, "Www.Example-Site.co.uk"sv, "a_b.example"sv, "-a-.b"sv,
+                            "ab--cd.example"sv, "0123456789.abcdefghijklmnopqrstuvwxyz.ABCDEFGHIJKLMNOPQRSTUVWXYZ"sv,
+                            "a.1"sv, "x"sv);
+      auto fast = std::string{};
+      REQUIRE(skyr::details::ascii_domain_to_ascii(input, &fast));
+      auto expected = std::string{};
+      REQUIRE(skyr::domain_to_ascii(input, &expected));
+      CHECK(fast == expected);
+    }
+
+    SECTION("domains that need the full pipeline") {
+      auto input = GENERATE(""sv, "a."sv, ".a"sv, "a..b"sv, "xn--nxasmq6b.com"sv, "a.XN--nxasmq6b"sv, "ex%41mple.com"sv,
+                            "ex ample.com"sv, "a+b.com"sv, "\xcf\x80.com"sv);
+      auto output = std::string{};
+      CHECK_FALSE(skyr::details::ascii_domain_to_ascii(input, &output));
+      CHECK(output.empty());
+    }
+
+    SECTION("parse uppercase domain") {
+      auto host = skyr::parse_host("WWW.EXAMPLE.COM"sv, false);
+      REQUIRE(host);
+      CHECK(host.value().serialize() == "www.example.com");
+    }
+
+    SECTION("parse domain that is an IPv4 address") {
+      CHECK(skyr::parse_host("192.168.0.1"sv, false).value().is_ipv4_address());
+      CHECK_FALSE(skyr::parse_host("192.168.0.256"sv, false));
+    }
+  }
 }
@@ -4,6 +4,8 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include <exception>
+#include <string_view>
+#include <vector>
 
 #include <catch2/catch_all.hpp>
 
@@ -40,3 +42,67 @@ TEST_CASE("query_parsing_example_tests", "[parse]") {
     CHECK(query.value()[1].value.value() == "e1f7bc78");
   }
 }
+
+TEST_CASE("query_parameters_view_tests", "[parse]") {
+  SECTION("iterate_parameters") {
+    auto parameters = skyr::query_parameters_view("?a=1&b&c=x%20y;d=");
+    auto names = std::vector<std::string_view>{};
+    for (auto [name, value] : parameters) {
+      names.push_back(name);
+    }
+    CHECK(names == std::vector<std::string_view>{"a", "b", "c", "d"});
+
+    auto it = parameters.begin();
+    CHECK((*it).value == "1");
+    ++it;
+    CHECK_FALSE((*it).value);
+    ++it;
+    CHECK((*it).value == "x%20y");
+    CHECK((*it).decoded_value() == "x y");
+    ++it;
+    CHECK((*it).value == "");
+    ++it;
+    CHECK(it == parameters.end());
+  }
+
+  SECTION("empty_parameters") {
+    CHECK(skyr::query_parameters_view("").empty());
+    CHECK(skyr::query_parameters_view("?").empty());
+    CHECK(std::ranges::distance(skyr::query_parameters_view("a&&b&")) == 4);
+  }
+
+  SECTION("find_by_decoded_name") {
+    auto parameters = skyr::query_parameters_view("x=0&api%20key=secret&%zz=1&id=2");
+    CHECK(parameters.find("api key")->value == "secret");
+    CHECK(parameters.find("%zz")->value == "1");
+    CHECK(parameters.find("id")->value == "2");
+    CHECK_FALSE(parameters.find("api"));
+    CHECK_FALSE(parameters.contains("api%20key"));
+  }
+
+  SECTION("parse_query_matches_view") {
+    auto query = skyr::parse_query("?a=b c&d&&e=%41");
+    REQUIRE(query);
+    REQUIRE(4 == query.value().size());
+    CHECK(query.value()[0].value == "b%20c");
+    CHECK_FALSE(query.value()[1].value);
+    CHECK(query.value()[2].name.empty());
+    CHECK(query.value()[3].value == "%41");
+  }
+
+  SECTION("value_as") {
+    auto parameters = skyr::query_parameters_view("page=3&id=%34%32&flag=0&x");
+    CHECK(parameters.find("page")->value_as<int>() == 3);
+    CHECK(parameters.find("id")->value_as<long>() == 42);
+    CHECK(parameters.find("flag")->value_as<bool>() == false);
+    CHECK(parameters.find("x")->value_as<int>().error() == skyr::query_value_errc::invalid_value);
+  }
+
+  SECTION("decoded_views") {
+    auto parameter = skyr::query_parameters_view("sort=last%20name&x").front();
+    CHECK(parameter.decoded_name_view().equals("sort"));
+    CHECK(parameter.decoded_value_view().equals("last name"));
+    CHECK(parameter.decoded_value_view().starts_with("last "));
+    CHECK(skyr::query_parameters_view("x").front().decoded_value_view().empty());
+  }
+}
@@ -135,4 +135,11 @@ TEST_CASE("url_serialize_tests", "[ipv6]") {
     REQUIRE(instance);
     CHECK("https://example.org/" == skyr::serialize_excluding_fragment(instance.value()));
   }
+
+  SECTION("hostless_path_with_empty_first_segment") {
+    auto instance = skyr::parse("web+demo:/.//not-a-host/");
+    REQUIRE(instance);
+    CHECK_FALSE(instance->host);
+    CHECK("web+demo:/.//not-a-host/" == skyr::serialize(instance.value()));
+  }
 }
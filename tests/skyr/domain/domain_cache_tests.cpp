@@ -0,0 +1,142 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/domain/domain_cache.hpp>
+#include <skyr/url.hpp>
+
+TEST_CASE("domain_cache", "[domain]") {
+  using namespace std::string_literals;
+
+  SECTION("to_ascii_miss_then_hit") {
+    auto cache = skyr::domain_cache(16);
+    auto ascii_domain = std::string{};
+    REQUIRE(cache.to_ascii("例子.测试", &ascii_domain));
+    CHECK(ascii_domain == "xn--fsqu00a.xn--0zwm56d");
+
+    ascii_domain.clear();
+    REQUIRE(cache.to_ascii("例子.测试", &ascii_domain));
+    CHECK(ascii_domain == "xn--fsqu00a.xn--0zwm56d");
+
+    auto stats = cache.stats();
+    CHECK(stats.hits == 1);
+    CHECK(stats.misses == 1);
+    CHECK(stats.evictions == 0);
+    CHECK(cache.size() == 1);
+  }
+
+  SECTION("to_u8") {
+    auto cache = skyr::domain_cache(16);
+    auto u8_domain = std::string{};
+    REQUIRE(cache.to_u8("xn--fsqu00a.xn--0zwm56d", &u8_domain));
+    CHECK(u8_domain == "例子.测试");
+    REQUIRE(cache.to_u8("xn--fsqu00a.xn--0zwm56d", &u8_domain));
+    CHECK(u8_domain == "例子.测试");
+    CHECK(cache.stats().hits == 1);
+  }
+
+  SECTION("directions_are_cached_separately") {
+    auto cache = skyr::domain_cache(16);
+    auto ascii_domain = std::string{}, u8_domain = std::string{};
+    REQUIRE(cache.to_ascii("xn--fsqu00a.xn--0zwm56d", &ascii_domain));
+    REQUIRE(cache.to_u8("xn--fsqu00a.xn--0zwm56d", &u8_domain));
+    CHECK(ascii_domain == "xn--fsqu00a.xn--0zwm56d");
+    CHECK(u8_domain == "例子.测试");
+    CHECK(cache.stats().misses == 2);
+  }
+
+  SECTION("errors_are_cached") {
+    auto cache = skyr::domain_cache(16);
+    auto ascii_domain = std::string{};
+    auto first = cache.to_ascii("\xff.example", &ascii_domain);
+    auto second = cache.to_ascii("\xff.example", &ascii_domain);
+    REQUIRE_FALSE(first);
+    REQUIRE_FALSE(second);
+    CHECK(first.error() == second.error());
+    CHECK(cache.stats().hits == 1);
+  }
+
+  SECTION("results_that_were_not_looked_up_are_evicted_first") {
+    auto cache = skyr::domain_cache(2, 1);
+    auto ascii_domain = std::string{};
+    REQUIRE(cache.to_ascii("münchen.de", &ascii_domain));
+    REQUIRE(cache.to_ascii("zürich.ch", &ascii_domain));
+    REQUIRE(cache.to_ascii("münchen.de", &ascii_domain));
+    REQUIRE(cache.to_ascii("köln.de", &ascii_domain));
+    CHECK(cache.stats().evictions == 1);
+    CHECK(cache.size() == 2);
+
+    REQUIRE(cache.to_ascii("münchen.de", &ascii_domain));
+    CHECK(ascii_domain == "xn--mnchen-3ya.de");
+    CHECK(cache.stats().hits == 2);
+  }
+
+  SECTION("clear") {
+    auto cache = skyr::domain_cache(16);
+    auto ascii_domain = std::string{};
+    REQUIRE(cache.to_ascii("münchen.de", &ascii_domain));
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK(cache.stats().misses == 0);
+  }
+
+  SECTION("installed_cache_is_used_by_the_parser") {
+    auto cache = skyr::domain_cache(16);
+    auto previous = skyr::set_domain_cache(&cache);
+    auto first = skyr::url("http://例子.测试/");
+    auto second = skyr::url("http://例子.测试/");
+    auto u8_domain = second.u8domain();
+    skyr::set_domain_cache(previous);
+
+    CHECK(first.host() == "xn--fsqu00a.xn--0zwm56d");
+    CHECK(second.host() == "xn--fsqu00a.xn--0zwm56d");
+    REQUIRE(u8_domain);
+    CHECK(u8_domain.value() == "例子.测试");
+    CHECK(cache.stats().hits == 1);
+    CHECK(cache.stats().misses == 2);
+  }
+
+  SECTION("concurrent_lookups") {
+    auto hosts = std::vector<std::string>{};
+    auto expected = std::vector<std::string>{};
+    for (auto i = 0; i < 100; ++i) {
+      hosts.push_back("例子" + std::to_string(i) + ".测试");
+      auto ascii_domain = std::string{};
+      REQUIRE(skyr::domain_to_ascii(hosts.back(), &ascii_domain));
+      expected.push_back(ascii_domain);
+    }
+
+    // Smaller than the number of hosts, so that results are evicted while they are looked up
+    auto cache = skyr::domain_cache(32, 8);
+    auto mismatches = std::atomic<int>{0};
+    auto threads = std::vector<std::thread>{};
+    for (auto t = 0; t < 64; ++t) {
+      threads.emplace_back([&, t]() {
+        auto ascii_domain = std::string{};
+        for (auto i = 0; i < 1000; ++i) {
+          auto index = static_cast<std::size_t>((i * 7 + t) % 100);
+          ascii_domain.clear();
+          if (!cache.to_ascii(hosts[index], &ascii_domain) || (ascii_domain != expected[index])) {
+            ++mismatches;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    CHECK(mismatches == 0);
+    auto stats = cache.stats();
+    CHECK(stats.hits + stats.misses == 64'000);
+    CHECK(cache.size() <= 32);
+  }
+}
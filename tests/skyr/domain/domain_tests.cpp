@@ -18,7 +18,9 @@ TEST_CASE("valid domains to ascii", "[domain]") {
       param{"example.com", "example.com"}, param{"sub.example.com", "sub.example.com"}, param{"⌘.ws", "xn--bih.ws"},
       param{"你好你好", "xn--6qqa088eba"}, param{"你好你好.com", "xn--6qqa088eba.com"},
       param{"उदाहरण.परीक्षा", "xn--p1b6ci4b4b3a.xn--11b5bs3a9aj6g"}, param{"faß.ExAmPlE", "xn--fa-hia.example"},
-      param{"βόλος.com", "xn--nxasmm1c.com"}, param{"Ｇｏ.com", "go.com"});
+      param{"βόλος.com", "xn--nxasmm1c.com"}, param{"Ｇｏ.com", "go.com"},
+      param{"例子.测试.", "xn--fsqu00a.xn--0zwm56d."}, param{"a。b", "a.b"}, param{"ĳ.com", "ij.com"},
+      param{"ǅ.com", "xn--d-toa.com"}, param{"ẞ.com", "xn--zca.com"});
 
   SECTION("domain_to_ascii_tests") {
     const auto& [input, expected] = domain;
@@ -30,13 +32,45 @@ TEST_CASE("valid domains to ascii", "[domain]") {
   }
 }
 
+TEST_CASE("domains with multiple code point mappings", "[domain]") {
+  SECTION("deviation_is_kept_when_nontransitional") {
+    auto output = std::string{};
+    auto result = skyr::domain_to_ascii("faß.de", &output, false, true, true, false, false, false);
+    REQUIRE(result);
+    CHECK("xn--fa-hia.de" == output);
+  }
+
+  SECTION("deviation_is_mapped_when_transitional") {
+    auto output = std::string{};
+    auto result = skyr::domain_to_ascii("faß.de", &output, false, true, true, false, true, false);
+    REQUIRE(result);
+    CHECK("fass.de" == output);
+  }
+
+  SECTION("joiner_is_removed_when_transitional") {
+    auto output = std::string{};
+    auto result = skyr::domain_to_ascii("a\xe2\x80\x8c" "b.de", &output, false, true, true, false, true, false);
+    REQUIRE(result);
+    CHECK("ab.de" == output);
+  }
+
+  SECTION("std3_mapping_to_several_code_points") {
+    // U+00A8 DIAERESIS maps to U+0020 U+0308
+    auto output = std::string{};
+    auto result = skyr::domain_to_ascii("a\xc2\xa8.de", &output, false, true, true, false, false, false);
+    REQUIRE(result);
+    CHECK("xn--a -vub.de" == output);
+  }
+}
+
 TEST_CASE("valid domains from ascii", "[domain]") {
   using param = std::pair<std::string, std::string>;
 
   auto domain =
       GENERATE(param{"example.com", "example.com"}, param{"⌘.ws", "xn--bih.ws"}, param{"你好你好", "xn--6qqa088eba"},
                param{"你好你好.com", "xn--6qqa088eba.com"},
-               param{"उदाहरण.परीक्षा", "xn--p1b6ci4b4b3a.xn--11b5bs3a9aj6g"}, param{"βόλος.com", "xn--nxasmm1c.com"});
+               param{"उदाहरण.परीक्षा", "xn--p1b6ci4b4b3a.xn--11b5bs3a9aj6g"}, param{"βόλος.com", "xn--nxasmm1c.com"},
+               param{"例子.测试.", "xn--fsqu00a.xn--0zwm56d."});
 
   SECTION("ascii_to_domain_tests") {
     const auto& [expected, input] = domain;
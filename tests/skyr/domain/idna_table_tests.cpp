@@ -4,6 +4,7 @@
 //  http://www.boost.org/LICENSE_1_0.txt)
 
 #include <exception>
+#include <string_view>
 
 #include <catch2/catch_all.hpp>
 
@@ -26,3 +27,56 @@ TEST_CASE("IDNA character values", "[idna]") {
     REQUIRE(status == skyr::idna::code_point_status(value));
   }
 }
+
+TEST_CASE("IDNA code point mapping", "[idna]") {
+  using namespace std::string_view_literals;
+
+  SECTION("ascii_upper_case") {
+    CHECK(skyr::idna::map_code_point(U'A') == U"a"sv);
+    CHECK(skyr::idna::map_code_point(U'Z') == U"z"sv);
+  }
+
+  SECTION("unmapped_code_points") {
+    CHECK(skyr::idna::map_code_point(U'a').empty());
+    CHECK(skyr::idna::map_code_point(U'\x4e2d').empty());
+    CHECK(skyr::idna::map_code_point(U'\x0627').empty());
+    CHECK(skyr::idna::map_code_point(U'\x1f600').empty());
+  }
+
+  SECTION("code_point_in_mapped_range") {
+    // U+0132..U+0133 both map to "ij"
+    CHECK(skyr::idna::map_code_point(U'\x0132') == U"ij"sv);
+    CHECK(skyr::idna::map_code_point(U'\x0133') == U"ij"sv);
+  }
+
+  SECTION("mapped_to_several_code_points") {
+    CHECK(skyr::idna::map_code_point(U'\x01c5') == U"d\x017e"sv);
+    CHECK(skyr::idna::map_code_point(U'\x00a8') == U" \x0308"sv);
+    CHECK(skyr::idna::map_code_point(U'\xfdfa').size() == 18);
+  }
+
+  SECTION("deviations") {
+    CHECK(skyr::idna::map_code_point(U'\x00df') == U"ss"sv);
+    CHECK(skyr::idna::map_code_point(U'\x03c2') == U"\x03c3"sv);
+    CHECK(skyr::idna::map_code_point(U'\x200c').empty());
+  }
+
+  SECTION("mapped_to_other_letters") {
+    CHECK(skyr::idna::map_code_point(U'\x210c') == U"h"sv);
+    CHECK(skyr::idna::map_code_point(U'\x2102') == U"c"sv);
+  }
+
+  SECTION("mapped_to_supplementary_plane") {
+    CHECK(skyr::idna::map_code_point(U'\xfa6c') == U"\x242ee"sv);
+  }
+
+  SECTION("lookups_are_constant_expressions") {
+    static_assert(skyr::idna::code_point_status(U'A') == skyr::idna::idna_status::mapped);
+    static_assert(skyr::idna::map_code_point(U'A') == U"a"sv);
+  }
+
+  SECTION("code_points_out_of_range") {
+    CHECK(skyr::idna::code_point_status(U'\x110000') == skyr::idna::idna_status::disallowed);
+    CHECK(skyr::idna::map_code_point(U'\x110000').empty());
+  }
+}
@@ -39,6 +39,22 @@ TEST_CASE("encode_test", "[punycode]") {
     REQUIRE(result);
     CHECK(expected == decoded);
   }
+
+  SECTION("encode_appends_to_output") {
+    const auto& [input, expected] = domain;
+    auto encoded = "xn--"s;
+    auto result = skyr::punycode_encode(input, &encoded);
+    REQUIRE(result);
+    CHECK("xn--" + expected == encoded);
+  }
+
+  SECTION("decode_appends_to_output") {
+    const auto& [expected, input] = domain;
+    auto decoded = U"."s;
+    auto result = skyr::punycode_decode(std::string_view(input), &decoded);
+    REQUIRE(result);
+    CHECK(U"." + expected == decoded);
+  }
 }
 
 TEST_CASE("special_strings") {
@@ -32,6 +32,13 @@ TEST_CASE("filesystem path", "[filesystem_path]") {
     CHECK(path.value().generic_string() == "/path/to/file.txt");
   }
 
+  SECTION("percent_encoded_path") {
+    auto instance = skyr::url{"file:///path/to/my%20file.txt"};
+    auto path = skyr::filesystem::to_path(instance);
+    REQUIRE(path);
+    CHECK(path.value().generic_string() == "/path/to/my file.txt");
+  }
+
   SECTION("from_path") {
     auto path = std::filesystem::path("/path/to/file.txt");
     auto url = skyr::filesystem::from_path(path);
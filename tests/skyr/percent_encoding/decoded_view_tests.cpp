@@ -0,0 +1,63 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/percent_encoding/decoded_view.hpp>
+#include <skyr/percent_encoding/percent_decode.hpp>
+
+static_assert(std::forward_iterator<skyr::percent_encoding::decoded_view::iterator>);
+static_assert(std::ranges::forward_range<skyr::percent_encoding::decoded_view>);
+static_assert(skyr::decoded_equals("a%20b", "a b"));
+
+TEST_CASE("decoded_view_tests", "[percent_decode]") {
+  using namespace std::string_view_literals;
+
+  SECTION("iterate") {
+    auto view = skyr::percent_encoding::decoded_view("%E2%9C%93 a%20b%2fc");
+    CHECK(std::string(view.begin(), view.end()) == "\xe2\x9c\x93 a b/c");
+    CHECK(std::ranges::distance(view) == 9);
+  }
+
+  SECTION("invalid_percent_encoding_is_kept") {
+    auto view = skyr::percent_encoding::decoded_view("%%41%4g%2");
+    CHECK(std::string(view.begin(), view.end()) == "%A%4g%2");
+  }
+
+  SECTION("empty") {
+    auto view = skyr::percent_encoding::decoded_view();
+    CHECK(view.empty());
+    CHECK(view.equals(""));
+    CHECK(view.starts_with(""));
+    CHECK_FALSE(view.starts_with("a"));
+  }
+
+  SECTION("matches_percent_decode") {
+    auto input = GENERATE("plain"sv, "caf%C3%A9"sv, "%20%20"sv, "a%2Fb%2fc"sv, "100%25"sv, "%7e%7E~"sv);
+    auto decoded = skyr::percent_decode(input).value();
+    auto view = skyr::percent_encoding::decoded_view(input);
+    CHECK(std::ranges::equal(view, decoded));
+    CHECK(skyr::decoded_equals(input, decoded));
+    CHECK(skyr::decoded_starts_with(input, decoded));
+    CHECK_FALSE(skyr::decoded_equals(input, decoded + "x"));
+    for (auto size = std::size_t{0}; size < decoded.size(); ++size) {
+      CHECK(skyr::decoded_starts_with(input, std::string_view(decoded).substr(0, size)));
+      CHECK_FALSE(skyr::decoded_equals(input, std::string_view(decoded).substr(0, size)));
+    }
+  }
+
+  SECTION("mismatch") {
+    CHECK_FALSE(skyr::decoded_equals("caf%C3%A9", "cafe"));
+    CHECK_FALSE(skyr::decoded_equals("a%20b", "a%20b"));
+    CHECK_FALSE(skyr::decoded_starts_with("/api%2Fv1", "/api/v2"));
+    CHECK_FALSE(skyr::decoded_starts_with("/a", "/ab"));
+    CHECK(skyr::decoded_starts_with("/api%2Fv1/users", "/api/v1/"));
+  }
+}
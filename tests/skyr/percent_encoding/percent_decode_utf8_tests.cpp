@@ -0,0 +1,77 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/percent_encoding/percent_decode.hpp>
+#include <skyr/percent_encoding/percent_decode_utf8.hpp>
+
+TEST_CASE("percent_decode_utf8_tests", "[percent_decode]") {
+  using namespace std::string_literals;
+  using namespace std::string_view_literals;
+
+  constexpr auto replacement = "\xef\xbf\xbd"sv;
+
+  SECTION("valid_utf8_matches_percent_decode") {
+    auto input = GENERATE("plain"sv, "caf%C3%A9"sv, "%F0%9F%8D%95 pizza"sv, "%E2%9C%93"sv, "\xcf\x80=%CF%80"sv,
+                          "%CF\x80"sv, "100%25"sv);
+    auto decoded = skyr::percent_decode_utf8(input, skyr::invalid_utf8::fail);
+    REQUIRE(decoded);
+    CHECK(decoded.value() == skyr::percent_decode(input).value());
+  }
+
+  SECTION("code_points") {
+    auto output = std::string{};
+    auto result = skyr::percent_decode_utf8_to(std::back_inserter(output), "/caf%C3%A9/%F0%9F%8D%95");
+    REQUIRE(result);
+    CHECK(result.value().code_points == 7);
+  }
+
+  SECTION("invalid_percent_encoding_is_kept") {
+    CHECK(skyr::percent_decode_utf8("%zz%4%").value() == "%zz%4%");
+  }
+
+  SECTION("invalid_sequences_are_replaced") {
+    CHECK(skyr::percent_decode_utf8("%FFa").value() == std::string(replacement) + "a");
+    CHECK(skyr::percent_decode_utf8("a%E2%82").value() == "a" + std::string(replacement));
+    CHECK(skyr::percent_decode_utf8("%E2%82a").value() == std::string(replacement) + "a");
+    CHECK(skyr::percent_decode_utf8("\xff").value() == replacement);
+  }
+
+  SECTION("maximal_subparts_are_replaced") {
+    auto replaced = [=](std::size_t count) {
+      auto result = std::string{};
+      for (auto i = std::size_t{0}; i < count; ++i) {
+        result += replacement;
+      }
+      return result;
+    };
+    CHECK(skyr::percent_decode_utf8("%C0%AF").value() == replaced(2));
+    CHECK(skyr::percent_decode_utf8("%F0%80%80").value() == replaced(3));
+    CHECK(skyr::percent_decode_utf8("%ED%A0%80").value() == replaced(3));
+    CHECK(skyr::percent_decode_utf8("%F4%90%80%80").value() == replaced(4));
+    CHECK(skyr::percent_decode_utf8("%F0%9F%8D").value() == replaced(1));
+  }
+
+  SECTION("fail") {
+    using skyr::unicode::unicode_errc;
+    CHECK(skyr::percent_decode_utf8("%FF", skyr::invalid_utf8::fail).error() == unicode_errc::invalid_lead);
+    CHECK(skyr::percent_decode_utf8("%E2a", skyr::invalid_utf8::fail).error() == unicode_errc::illegal_byte_sequence);
+    CHECK(skyr::percent_decode_utf8("%E2%82", skyr::invalid_utf8::fail).error() == unicode_errc::overflow);
+  }
+
+  SECTION("long_ascii_runs") {
+    auto prefix = std::string(70, 'a');
+    for (auto position = std::size_t{0}; position <= prefix.size(); ++position) {
+      auto input = prefix.substr(0, position) + "%CF%80\xcf\x80" + prefix.substr(position) + "\xff";
+      auto expected = prefix.substr(0, position) + "\xcf\x80\xcf\x80" + prefix.substr(position) + "\xef\xbf\xbd";
+      CHECK(skyr::percent_decode_utf8(input).value() == expected);
+    }
+  }
+}
@@ -9,6 +9,9 @@
 #define FMT_HEADER_ONLY
 #include <exception>
 #include <format>
+#include <optional>
+#include <string>
+#include <string_view>
 
 #include <skyr/percent_encoding/percent_decode.hpp>
 
@@ -33,4 +36,81 @@ TEST_CASE("percent_decode", "[percent_decode]") {
     auto decoded = skyr::percent_decode("");
     CHECK(decoded);
   }
+
+  SECTION("matches_percent_decode_range") {
+    auto inputs = GENERATE(as<std::string>{}, "", "abc", "%", "%4", "%41", "a%41b%42c", "%zz", "%4z", "a%", "a%2",
+                           "%%41", "%2541", "100%25 sure", "%e2%9c%93%E2%9C%93", "no escapes at all, just text");
+    auto expected = std::string{};
+    auto error = std::optional<skyr::percent_encoding::percent_encode_errc>{};
+    for (auto&& byte : skyr::percent_encoding::percent_decode_range{inputs}) {
+      if (!byte) {
+        error = byte.error();
+        break;
+      }
+      expected.push_back(byte.value());
+    }
+
+    auto decoded = skyr::percent_decode(inputs);
+    if (error) {
+      REQUIRE_FALSE(decoded);
+      CHECK(decoded.error() == error.value());
+    } else {
+      REQUIRE(decoded);
+      CHECK(decoded.value() == expected);
+    }
+  }
+
+  SECTION("decode_view_without_escapes_is_the_input") {
+    auto buffer = std::string{};
+    auto input = std::string_view("plain-text");
+    auto decoded = skyr::percent_decode_view(input, buffer);
+    REQUIRE(decoded);
+    CHECK(decoded.value().data() == input.data());
+    CHECK(buffer.empty());
+  }
+
+  SECTION("decode_view_uses_the_buffer") {
+    auto buffer = std::string{};
+    auto decoded = skyr::percent_decode_view("a%20b", buffer);
+    REQUIRE(decoded);
+    CHECK(decoded.value() == "a b");
+    CHECK(decoded.value().data() == buffer.data());
+    CHECK_FALSE(skyr::percent_decode_view("a%2", buffer));
+  }
+  SECTION("decode_in_place") {
+    auto buffer = "%E2%9C%93 a%20b%2fc"s;
+    auto size = skyr::percent_decode_in_place(buffer);
+    REQUIRE(size);
+    CHECK(size.value() == 9);
+    CHECK(buffer == "\xe2\x9c\x93 a b/c");
+  }
+
+  SECTION("decode_span_in_place") {
+    char buffer[] = {'x', '%', '4', '1', 'y', 'z'};
+    auto size = skyr::percent_decode_in_place(buffer);
+    REQUIRE(size);
+    CHECK(std::string_view(buffer, size.value()) == "xAyz");
+  }
+
+  SECTION("decode_in_place_overlapping_runs") {
+    auto buffer = "%41bcdefghijklmnop%42qrstuvwxyz%430123456789"s;
+    auto size = skyr::percent_decode_in_place(buffer);
+    REQUIRE(size);
+    CHECK(buffer == "AbcdefghijklmnopBqrstuvwxyzC0123456789");
+  }
+
+  SECTION("decode_in_place_without_escapes") {
+    auto buffer = "plain-text"s;
+    auto size = skyr::percent_decode_in_place(buffer);
+    REQUIRE(size);
+    CHECK(buffer == "plain-text");
+  }
+
+  SECTION("decode_in_place_errors") {
+    auto overflow = "a%2"s;
+    auto non_hex = "a%zz"s;
+    CHECK(skyr::percent_decode_in_place(overflow).error() == skyr::percent_encoding::percent_encode_errc::overflow);
+    CHECK(skyr::percent_decode_in_place(non_hex).error() ==
+          skyr::percent_encoding::percent_encode_errc::non_hex_input);
+  }
 }
@@ -7,9 +7,14 @@
 
 #include <catch2/catch_all.hpp>
 #define FMT_HEADER_ONLY
+#include <array>
 #include <exception>
 #include <format>
+#include <string>
+#include <string_view>
 
+#include <skyr/percent_encoding/byte_set.hpp>
+#include <skyr/percent_encoding/percent_encode.hpp>
 #include <skyr/percent_encoding/percent_encoded_char.hpp>
 
 TEST_CASE("encode fragment", "[percent_encoding]") {
@@ -72,3 +77,91 @@ TEST_CASE("encode_tests", "[percent_encoding]") {
     CHECK("%2B" == encoded.to_string());
   }
 }
+
+TEST_CASE("encode bytes", "[percent_encoding]") {
+  using skyr::percent_encoding::encode_set;
+
+  auto encodes = GENERATE(encode_set::any, encode_set::c0_control, encode_set::fragment, encode_set::query,
+                          encode_set::special_query, encode_set::path, encode_set::userinfo, encode_set::component,
+                          encode_set::form_urlencoded);
+
+  // Every byte value, repeated at each offset, so that the vectorized
+  // kernels see each byte in every lane and in the scalar tail
+  auto input = std::string{};
+  for (auto offset = 0u; offset < 64u; ++offset) {
+    for (auto value = 0u; value < 256u; ++value) {
+      input.push_back(static_cast<char>((value * 7u + offset) & 0xffu));
+    }
+    input.append(offset, 'a');
+  }
+
+  SECTION("byte_set_matches_encode_set") {
+    const auto& bytes = skyr::percent_encoding::encode_set_bytes(encodes);
+    for (auto value = 0u; value < 256u; ++value) {
+      auto encoded = skyr::percent_encoding::percent_encode_byte(std::byte(value), encodes);
+      CHECK(bytes.contains(std::byte(value)) == encoded.is_encoded());
+    }
+  }
+
+  SECTION("percent_encode_bytes_matches_percent_encode_byte") {
+    for (auto length : {0ul, 1ul, 15ul, 16ul, 17ul, 31ul, 32ul, 33ul, 100ul, input.size()}) {
+      auto view = std::string_view(input).substr(input.size() - length);
+      auto expected = std::string{};
+      for (auto c : view) {
+        expected += skyr::percent_encoding::percent_encode_byte(std::byte(c), encodes).to_string();
+      }
+      CHECK(skyr::percent_encode_bytes(view, encodes) == expected);
+    }
+  }
+
+  SECTION("kernels_match_scalar_kernels") {
+    using namespace skyr::percent_encoding::details;
+
+    // Every kernel that the CPU supports is run, not only the one chosen at run time
+    const auto& bytes = skyr::percent_encoding::encode_set_bytes(encodes);
+    auto first = input.data(), last = input.data() + input.size();
+    auto ascii = std::string(100, 'x');
+    for (auto kernel : {simd_kernel::scalar, simd_kernel::ssse3, simd_kernel::avx2, simd_kernel::neon}) {
+      if (!is_supported(kernel)) {
+        continue;
+      }
+
+      INFO("kernel = " << static_cast<int>(kernel));
+      CHECK(count(bytes, first, last, kernel) == scalar_count(bytes, first, last));
+      for (auto it = first; it != last; ++it) {
+        REQUIRE(find_first_of(bytes, it, last, kernel) == scalar_find_first_of(bytes, it, last));
+      }
+      CHECK(find_first_of(bytes, ascii.data(), ascii.data() + ascii.size(), kernel) ==
+            scalar_find_first_of(bytes, ascii.data(), ascii.data() + ascii.size()));
+    }
+    CHECK(is_supported(best_simd_kernel()));
+  }
+}
+
+TEST_CASE("lowercase ascii", "[percent_encoding]") {
+  using namespace skyr::percent_encoding::details;
+
+  auto input = std::string{};
+  for (auto offset = 0u; offset < 64u; ++offset) {
+    for (auto value = 0u; value < 256u; ++value) {
+      input.push_back(static_cast<char>((value * 7u + offset) & 0xffu));
+    }
+    input.append(offset, 'A');
+  }
+
+  auto expected = std::string(input.size(), '\0');
+  scalar_ascii_to_lower(input.data(), input.data() + input.size(), expected.data());
+  for (auto kernel : {simd_kernel::scalar, simd_kernel::ssse3, simd_kernel::avx2, simd_kernel::neon}) {
+    if (!is_supported(kernel)) {
+      continue;
+    }
+
+    INFO("kernel = " << static_cast<int>(kernel));
+    for (auto length : {0ul, 1ul, 15ul, 16ul, 17ul, 31ul, 32ul, 33ul, 100ul, input.size()}) {
+      auto output = std::string(length, '\0');
+      auto last = ascii_to_lower(input.data(), input.data() + length, output.data(), kernel);
+      CHECK(last == output.data() + length);
+      CHECK(output == std::string_view(expected).substr(0, length));
+    }
+  }
+}
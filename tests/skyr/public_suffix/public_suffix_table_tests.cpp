@@ -0,0 +1,45 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <string>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/public_suffix/public_suffix_list.hpp>
+
+// Generated from public_suffix_list_excerpt.dat by make_public_suffix_table when the test is built
+#include <public_suffix_test_table.hpp>
+
+TEST_CASE("public_suffix_table", "[public_suffix]") {
+  auto expected = skyr::public_suffix_list::load(SKYR_PUBLIC_SUFFIX_TEST_LIST);
+  REQUIRE(expected);
+  auto list = skyr::compiled_public_suffix_list();
+
+  SECTION("tables_match_compile") {
+    auto same_node = [](const skyr::public_suffix_node& lhs, const skyr::public_suffix_node& rhs) {
+      return (lhs.first_edge == rhs.first_edge) && (lhs.edge_count == rhs.edge_count) && (lhs.flags == rhs.flags);
+    };
+    auto same_edge = [](const skyr::public_suffix_edge& lhs, const skyr::public_suffix_edge& rhs) {
+      return (lhs.label_offset == rhs.label_offset) && (lhs.label_length == rhs.label_length) &&
+             (lhs.node == rhs.node);
+    };
+
+    CHECK(std::ranges::equal(list.nodes(), expected->nodes(), same_node));
+    CHECK(std::ranges::equal(list.edges(), expected->edges(), same_edge));
+    CHECK(list.labels() == expected->labels());
+    CHECK(std::ranges::equal(list.index(), expected->index()));
+  }
+
+  SECTION("lookups_match_compile") {
+    auto host = GENERATE(as<std::string>{}, "www.example.co.uk", "a.b.c.kobe.jp", "www.city.kobe.jp", "a.b.test.ck",
+                         "www.www.ck", "a.shishi.xn--55qx5d.cn", "a.b.blogspot.com", "foo.github.io",
+                         "www.example.com.", "example.unlisted", "192.168.0.1");
+    INFO("host = " << host);
+    CHECK(list.public_suffix(host) == expected->public_suffix(host));
+    CHECK(list.registrable_domain(host) == expected->registrable_domain(host));
+    CHECK(list.registrable_domain(host, false) == expected->registrable_domain(host, false));
+  }
+}
@@ -0,0 +1,118 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/public_suffix/public_suffix_list.hpp>
+
+namespace {
+auto compiled_list() -> const skyr::public_suffix_list& {
+  static const auto list = skyr::public_suffix_list::load(SKYR_PUBLIC_SUFFIX_TEST_LIST).value();
+  return list;
+}
+}  // namespace
+
+TEST_CASE("registrable domains", "[public_suffix]") {
+  using param = std::pair<std::string, std::optional<std::string>>;
+
+  auto host = GENERATE(
+      param{"", std::nullopt}, param{".com", std::nullopt}, param{".example.com", std::nullopt},
+      param{"example", std::nullopt}, param{"example.example", "example.example"},
+      param{"b.example.example", "example.example"}, param{"com", std::nullopt}, param{"example.com", "example.com"},
+      param{"a.b.example.com", "example.com"}, param{"www.example.com.", "example.com."},
+      param{"co.uk", std::nullopt}, param{"example.co.uk", "example.co.uk"},
+      param{"www.example.co.uk", "example.co.uk"}, param{"jp", std::nullopt}, param{"test.jp", "test.jp"},
+      param{"ac.jp", std::nullopt}, param{"www.test.ac.jp", "test.ac.jp"}, param{"kobe.jp", "kobe.jp"},
+      param{"c.kobe.jp", std::nullopt}, param{"a.b.c.kobe.jp", "b.c.kobe.jp"},
+      param{"city.kobe.jp", "city.kobe.jp"}, param{"www.city.kobe.jp", "city.kobe.jp"}, param{"ck", std::nullopt},
+      param{"test.ck", std::nullopt}, param{"a.b.test.ck", "b.test.ck"}, param{"www.ck", "www.ck"},
+      param{"www.www.ck", "www.ck"}, param{"xn--55qx5d.cn", std::nullopt},
+      param{"a.shishi.xn--55qx5d.cn", "shishi.xn--55qx5d.cn"}, param{"blogspot.com", std::nullopt},
+      param{"a.b.blogspot.com", "b.blogspot.com"}, param{"192.168.0.1", std::nullopt},
+      param{"[::1]", std::nullopt}, param{"example..com", std::nullopt}, param{"a..example.com", std::nullopt},
+      param{"example.com..", std::nullopt}, param{"www.city.kobe.jp.", "city.kobe.jp."});
+
+  SECTION("registrable_domain_tests") {
+    const auto& [input, expected] = host;
+    INFO("input = " << input << ", expected = " << expected.value_or("null"));
+    CHECK(compiled_list().registrable_domain(input) == expected);
+  }
+}
+
+TEST_CASE("public_suffix_list", "[public_suffix]") {
+  using namespace std::string_view_literals;
+
+  SECTION("public_suffix") {
+    CHECK(compiled_list().public_suffix("www.example.co.uk") == "co.uk"sv);
+    CHECK(compiled_list().public_suffix("co.uk") == "co.uk"sv);
+    CHECK(compiled_list().public_suffix("a.b.c.kobe.jp") == "c.kobe.jp"sv);
+    CHECK(compiled_list().public_suffix("www.city.kobe.jp") == "kobe.jp"sv);
+    CHECK(compiled_list().public_suffix("www.example.unlisted") == "unlisted"sv);
+    CHECK(compiled_list().public_suffix("example.com.") == "com."sv);
+    CHECK_FALSE(compiled_list().public_suffix("a..example.com"));
+    CHECK_FALSE(compiled_list().public_suffix("."));
+    CHECK_FALSE(compiled_list().public_suffix("127.0.0.1"));
+  }
+
+  SECTION("private_rules_can_be_excluded") {
+    CHECK(compiled_list().public_suffix("foo.github.io") == "github.io"sv);
+    CHECK(compiled_list().public_suffix("foo.github.io", false) == "io"sv);
+    CHECK(compiled_list().registrable_domain("a.b.blogspot.com", false) == "blogspot.com"sv);
+  }
+
+  SECTION("is_same_site") {
+    CHECK(compiled_list().is_same_site("www.example.co.uk", "example.co.uk"));
+    CHECK(compiled_list().is_same_site("a.example.com", "b.example.com"));
+    CHECK_FALSE(compiled_list().is_same_site("example.co.uk", "other.co.uk"));
+    CHECK_FALSE(compiled_list().is_same_site("a.github.io", "b.github.io"));
+    CHECK(compiled_list().is_same_site("a.github.io", "b.github.io", false));
+    CHECK(compiled_list().is_same_site("co.uk", "co.uk"));
+    CHECK_FALSE(compiled_list().is_same_site("co.uk", "example.co.uk"));
+    CHECK(compiled_list().is_same_site("192.168.0.1", "192.168.0.1"));
+    CHECK(compiled_list().is_same_site("www.example.com.", "example.com."));
+    CHECK_FALSE(compiled_list().is_same_site("example.com.", "example.com"));
+    CHECK_FALSE(compiled_list().is_same_site("example.com", "example.com."));
+  }
+
+  SECTION("empty_list_applies_the_default_rule") {
+    auto list = skyr::public_suffix_list{};
+    CHECK(list.public_suffix("www.example.co.uk") == "uk"sv);
+    CHECK(list.registrable_domain("www.example.co.uk") == "co.uk"sv);
+  }
+
+  SECTION("tables_can_be_shared") {
+    const auto& compiled = compiled_list();
+    auto list = skyr::public_suffix_list(compiled.nodes(), compiled.edges(), compiled.labels(), compiled.index());
+    CHECK(list.registrable_domain("www.city.kobe.jp") == "city.kobe.jp"sv);
+    CHECK(list.registrable_domain("a.b.test.ck") == "b.test.ck"sv);
+  }
+
+  SECTION("identical_subtrees_are_merged") {
+    auto list = skyr::public_suffix_list::compile("ac.jp\nco.jp\nac.uk\nco.uk\n");
+    REQUIRE(list);
+    // The root, `jp` and `uk`, and `ac` and `co`
+    CHECK(list->nodes().size() == 3);
+    CHECK(list->edges().size() == 4);
+    CHECK(list->registrable_domain("example.co.uk") == "example.co.uk"sv);
+    CHECK(list->registrable_domain("co.jp") == std::nullopt);
+  }
+
+  SECTION("invalid_rules") {
+    auto list = skyr::public_suffix_list::compile("com\nfoo.*.bar\n");
+    REQUIRE_FALSE(list);
+    CHECK(list.error() == skyr::public_suffix_errc::invalid_rule);
+  }
+
+  SECTION("file_not_found") {
+    auto list = skyr::public_suffix_list::load("does/not/exist/public_suffix_list.dat");
+    REQUIRE_FALSE(list);
+    CHECK(list.error() == skyr::public_suffix_errc::cannot_open_file);
+  }
+}
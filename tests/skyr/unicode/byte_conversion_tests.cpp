@@ -19,3 +19,21 @@ TEST_CASE("weird_02", "byte_conversion_tests") {
   auto bytes = skyr::details::to_u8("/\xf0\x9f\x8d\xa3\xf0\x9f\x8d\xba");
   CHECK(bytes);
 }
+
+TEST_CASE("utf8_sources_are_not_copied", "byte_conversion_tests") {
+  auto input = std::string("http://example.com/");
+  auto bytes = skyr::details::to_u8(input);
+  REQUIRE(bytes);
+  CHECK(bytes.value().data() == input.data());
+  CHECK(bytes.value().size() == input.size());
+
+  auto u8input = std::u8string(u8"http://example.com/\u03c0");
+  auto u8bytes = skyr::details::to_u8(u8input);
+  REQUIRE(u8bytes);
+  CHECK(static_cast<const void*>(u8bytes.value().data()) == static_cast<const void*>(u8input.data()));
+  CHECK(u8bytes.value() == "http://example.com/\xcf\x80");
+
+  auto literal = skyr::details::to_u8("http://example.com/");
+  REQUIRE(literal);
+  CHECK(literal.value() == "http://example.com/");
+}
@@ -3,8 +3,12 @@
 // (See accompanying file LICENSE_1_0.txt of copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <array>
+#include <cstddef>
 #include <exception>
 #include <format>
+#include <string>
+#include <string_view>
 
 #include <catch2/catch_all.hpp>
 
@@ -189,6 +193,81 @@ TEST_CASE("url_format_tests", "[url][format]") {
     CHECK(decoded == "example.com");
   }
 
+  SECTION("format_width_fill_and_align") {
+    CHECK(std::format("[{:>14h}]", url) == "[   example.com]");
+    CHECK(std::format("[{:14h}]", url) == "[example.com   ]");
+    CHECK(std::format("[{:*^15h}]", url) == "[**example.com**]");
+    CHECK(std::format("[{:>3h}]", url) == "[example.com]");
+    CHECK(std::format("[{:>8}]", skyr::url("http://a/")) == "[http://a/]");
+    CHECK(std::format("[{:-<12}]", skyr::url("http://a/")) == "[http://a/---]");
+  }
+
+  SECTION("format_width_pads_decoded_and_encoded_output") {
+    auto url_pi = skyr::url("http://example.com/%CF%80");
+    CHECK(std::format("[{:>4Pd}]", url_pi) == "[  /π]");
+    CHECK(std::format("[{:>7P}]", url_pi) == "[/%CF%80]");
+    CHECK(std::format("[{:>8P}]", url_pi) == "[ /%CF%80]");
+  }
+
+  SECTION("format_decoded_width_matches_string_width") {
+    // Decoded output is padded as the same text would be as a string, with or without a '%'
+    auto url_wide = skyr::url("http://example.com/%E4%BD%A0%E5%A5%BD");
+    CHECK(std::format("[{:>8Pd}]", url_wide) == std::format("[{:>8}]", std::string_view("/你好")));
+    CHECK(std::format("[{:*^9Pd}]", url_wide) == std::format("[{:*^9}]", std::string_view("/你好")));
+    CHECK(std::format("[{:>8Pd}]", skyr::url("http://example.com/你好")) ==
+          std::format("[{:>8Pd}]", url_wide));
+  }
+
+  SECTION("format_dynamic_width") {
+    auto url_pi = skyr::url("http://example.com/%CF%80");
+    CHECK(std::format("[{:>{}h}]", url, 14) == "[   example.com]");
+    CHECK(std::format("[{:{}}]", skyr::url("http://a/"), 12) == "[http://a/   ]");
+    CHECK(std::format("[{:*>{}Pd}]", url_pi, 4) == "[**/π]");
+    CHECK(std::format("[{:>{}P}]", url_pi, 8) == "[ /%CF%80]");
+    CHECK(std::format("[{1:>{0}Pd}]", 4, url_pi) == "[  /π]");
+    CHECK(std::format("[{:{}Pd}]", url_pi, 0) == "[/π]");
+  }
+
+  SECTION("format_dynamic_width_must_be_an_integer") {
+    auto text = std::string_view("4");
+    CHECK_THROWS_AS(std::vformat("{:{}P}", std::make_format_args(url, text)), std::format_error);
+    auto negative = -1;
+    CHECK_THROWS_AS(std::vformat("{:{}P}", std::make_format_args(url, negative)), std::format_error);
+  }
+
+  SECTION("format_long_decoded_component_is_padded") {
+    auto segment = std::string{};
+    for (auto i = 0; i < 100; ++i) {
+      segment += "%CF%80";
+    }
+    auto url_long = skyr::url("http://example.com/" + segment);
+    auto expected = std::string("**/");
+    for (auto i = 0; i < 100; ++i) {
+      expected += "π";
+    }
+    CHECK(std::format("{:*>103Pd}", url_long) == expected);
+  }
+
+  SECTION("format_decode_falls_back_to_encoded") {
+    auto url_bad = skyr::url("http://example.com/a%zzb");
+    CHECK(std::format("{:Pd}", url_bad) == "/a%zzb");
+    CHECK(std::format("{:>8Pd}", url_bad) == "  /a%zzb");
+  }
+
+  SECTION("format_decode_replaces_invalid_utf8") {
+    auto url_invalid = skyr::url("http://example.com/%FF%CF%80");
+    CHECK(std::format("{:Pd}", url_invalid) == "/\xef\xbf\xbd\xcf\x80");
+    CHECK(std::format("[{:>4Pd}]", url_invalid) == "[ /\xef\xbf\xbd\xcf\x80]");
+  }
+
+  SECTION("format_to_n_truncates") {
+    auto buffer = std::array<char, 8>{};
+    auto result = std::format_to_n(buffer.data(), static_cast<std::ptrdiff_t>(buffer.size()), "{:Pd}",
+                                   skyr::url("http://example.com/hello%20world"));
+    CHECK(std::string_view(buffer.data(), result.out) == "/hello w");
+    CHECK(result.size == 12);
+  }
+
   // Note: Invalid format specs (like {:x} or {:sh}) are caught at compile-time,
   // not runtime, so we can't test them here. The compiler will reject invalid specs.
 }
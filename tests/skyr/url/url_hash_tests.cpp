@@ -0,0 +1,96 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/url.hpp>
+
+TEST_CASE("url_hash_tests", "[url]") {
+  SECTION("std_hash_url") {
+    auto a = skyr::url("HTTP://Example.com:80/a/./b");
+    auto b = skyr::url("http://example.com/a/b");
+    CHECK(a == b);
+    CHECK(std::hash<skyr::url>{}(a) == std::hash<skyr::url>{}(b));
+    CHECK(std::hash<skyr::url>{}(a) == std::hash<std::string_view>{}("http://example.com/a/b"));
+
+    auto urls = std::unordered_set<skyr::url>{a, b, skyr::url("http://example.com/c")};
+    CHECK(urls.size() == 2);
+  }
+
+  SECTION("heterogeneous_lookup") {
+    auto urls = std::unordered_set<skyr::url, skyr::url_hash, skyr::url_equal>{};
+    urls.emplace("https://example.com/a?x=1");
+    urls.emplace("https://example.com/b");
+    CHECK(urls.contains(std::string_view("https://example.com/a?x=1")));
+    CHECK(urls.find(std::string_view("https://example.com/b")) != urls.end());
+    CHECK_FALSE(urls.contains(std::string_view("https://example.com/c")));
+
+    auto counts = std::unordered_map<skyr::url, int, skyr::url_hash, skyr::url_equal>{};
+    counts[skyr::url("https://example.com/")] = 1;
+    CHECK(counts.contains(std::string_view("https://example.com/")));
+  }
+
+  SECTION("url_record") {
+    auto a = skyr::parse("https://example.com/a/b?q#f");
+    auto b = skyr::parse("https://EXAMPLE.com:443/a/c/../b?q#f");
+    auto c = skyr::parse("https://example.com/a/b?q");
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(c);
+    CHECK(a.value() == b.value());
+    CHECK_FALSE(a.value() == c.value());
+    CHECK(std::hash<skyr::url_record>{}(a.value()) == std::hash<skyr::url_record>{}(b.value()));
+    CHECK(std::hash<skyr::url_record>{}(a.value()) != std::hash<skyr::url_record>{}(c.value()));
+  }
+
+  SECTION("host_and_addresses") {
+    auto validation_error = false;
+    auto ipv4 = skyr::host{skyr::ipv4_address(0x7f000001)};
+    auto ipv6 = skyr::host{skyr::parse_ipv6_address("::1", &validation_error).value()};
+    auto domain = skyr::host{skyr::domain_name{"example.com"}};
+    CHECK(ipv4 == skyr::host{skyr::parse_ipv4_address("127.0.0.1", &validation_error).value()});
+    CHECK(ipv4 != ipv6);
+    CHECK(domain == skyr::host{skyr::domain_name{"example.com"}});
+    CHECK(domain != skyr::host{skyr::opaque_host{"example.com"}});
+
+    auto hosts = std::unordered_set<skyr::host>{ipv4, ipv6, domain, skyr::host{skyr::domain_name{"example.com"}}};
+    CHECK(hosts.size() == 3);
+
+    CHECK(std::hash<skyr::ipv4_address>{}(skyr::ipv4_address(1)) ==
+          std::hash<skyr::ipv4_address>{}(skyr::ipv4_address(1)));
+    CHECK(std::hash<skyr::ipv6_address>{}(skyr::parse_ipv6_address("0:0::1", &validation_error).value()) ==
+          std::hash<skyr::ipv6_address>{}(skyr::parse_ipv6_address("::1", &validation_error).value()));
+  }
+
+  SECTION("component_hashes") {
+    auto a = skyr::url("https://example.com/a#x");
+    auto b = skyr::url("https://example.com/a#y");
+    auto c = skyr::url("https://example.com:443/b");
+    CHECK(skyr::url_without_fragment_hash{}(a) == skyr::url_without_fragment_hash{}(b));
+    CHECK(skyr::url_without_fragment_hash{}(a) == skyr::url_hash{}(std::string_view("https://example.com/a")));
+    CHECK(skyr::url_host_hash{}(a) == skyr::url_host_hash{}(c));
+    CHECK(skyr::url_origin_hash{}(a) == skyr::url_origin_hash{}(c));
+    CHECK(skyr::url_origin_hash{}(a) != skyr::url_origin_hash{}(skyr::url("http://example.com/a")));
+  }
+
+  SECTION("opaque_origin_hash_is_deterministic") {
+    auto instance = skyr::url("data:text/plain,hello");
+    REQUIRE(skyr::origin(instance).is_opaque());
+    CHECK(skyr::url_origin_hash{}(instance) == skyr::url_origin_hash{}(instance));
+    CHECK(skyr::url_origin_hash{}(instance) == skyr::url_origin_hash{}(skyr::url("data:text/plain,hello")));
+
+    auto urls = std::unordered_set<skyr::url, skyr::url_origin_hash, skyr::url_equal>{};
+    urls.insert(instance);
+    urls.insert(skyr::url("https://example.com/"));
+    CHECK(urls.contains(skyr::url("data:text/plain,hello")));
+    CHECK(urls.contains(skyr::url("https://example.com/")));
+    CHECK_FALSE(urls.contains(skyr::url("data:text/plain,other")));
+  }
+}
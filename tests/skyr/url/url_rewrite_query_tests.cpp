@@ -0,0 +1,106 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_all.hpp>
+
+#include <skyr/core/rewrite_query.hpp>
+#include <skyr/url.hpp>
+
+TEST_CASE("url_rewrite_query_tests", "[url]") {
+  SECTION("drop_by_predicate") {
+    auto instance = skyr::url("https://example.com/a?id=1&utm_source=x&q=a%20b#top");
+    auto result = instance.rewrite_query([](std::string_view name, std::string_view) {
+      return name.starts_with("utm_") ? skyr::query_rewrite::drop() : skyr::query_rewrite::keep();
+    });
+    CHECK(result.href() == "https://example.com/a?id=1&q=a%20b#top");
+    CHECK(result.search() == "?id=1&q=a%20b");
+    CHECK(result.hash() == "#top");
+    CHECK(result.search_parameters().get("q") == "a b");
+    CHECK(instance.href() == "https://example.com/a?id=1&utm_source=x&q=a%20b#top");
+  }
+
+  SECTION("replace_values") {
+    auto instance = skyr::url("https://example.com/?session=abc&id=1&flag");
+    auto result = instance.rewrite_query([](std::string_view name, std::string_view value) {
+      if (name == "session") {
+        return skyr::query_rewrite::replace("hidden");
+      }
+      return value.empty() ? skyr::query_rewrite::replace("1") : skyr::query_rewrite::keep();
+    });
+    CHECK(result.href() == "https://example.com/?session=hidden&id=1&flag=1");
+  }
+
+  SECTION("dropping_every_parameter_removes_the_query") {
+    auto instance = skyr::url("https://example.com/path?a=1&b=2#frag");
+    auto result = instance.rewrite_query([](std::string_view, std::string_view) {
+      return skyr::query_rewrite::drop();
+    });
+    CHECK(result.href() == "https://example.com/path#frag");
+    CHECK_FALSE(result.record().query);
+    CHECK(result.search().empty());
+  }
+
+  SECTION("unchanged_query_shares_storage") {
+    auto instance = skyr::url("https://example.com/?a=1&b=2");
+    auto result = instance.rewrite_query({"c", "d*"});
+    CHECK(result.href_view().data() == instance.href_view().data());
+  }
+
+  SECTION("rvalue_reuses_storage") {
+    auto instance = skyr::url("https://example.com/?gclid=1&a=1");
+    auto result = std::move(instance).rewrite_query({"gclid"});
+    CHECK(result.href() == "https://example.com/?a=1");
+    CHECK(result.pathname() == "/");
+  }
+
+  SECTION("name_set_with_prefixes") {
+    auto names = skyr::query_name_set({"fbclid", "gclid", "utm_*", "utm_source*", "mc_*"});
+    CHECK(names.contains("fbclid"));
+    CHECK(names.contains("utm_"));
+    CHECK(names.contains("utm_campaign"));
+    CHECK(names.contains("mc_eid"));
+    CHECK_FALSE(names.contains("utm"));
+    CHECK_FALSE(names.contains("fbclid2"));
+    CHECK_FALSE(names.contains("mc"));
+    CHECK_FALSE(names.contains("id"));
+    CHECK_FALSE(names.contains(""));
+
+    auto instance = skyr::url("https://example.com/?utm_source=a&id=1&utm_medium=b&fbclid=c&%75tm_term=d");
+    CHECK(instance.rewrite_query(names).href() == "https://example.com/?id=1");
+  }
+
+  SECTION("name_set_from_range") {
+    auto patterns = std::vector<std::string>{"b", "a", "b", "x*"};
+    auto names = skyr::query_name_set(patterns);
+    CHECK(names.contains("a"));
+    CHECK(names.contains("b"));
+    CHECK(names.contains("xyz"));
+    CHECK_FALSE(names.contains("c"));
+    CHECK(skyr::query_name_set({"*"}).contains("anything"));
+    CHECK(skyr::query_name_set({"*"}).contains(""));
+    CHECK(skyr::query_name_set().empty());
+  }
+
+  SECTION("rewrite_raw_query") {
+    CHECK(skyr::rewrite_query("a=1&&b=2&c", skyr::query_name_set({"b"})) == "a=1&c");
+    CHECK(skyr::rewrite_query("", skyr::query_name_set({"b"})).empty());
+  }
+
+  SECTION("empty_query") {
+    auto instance = skyr::url("https://example.com/?");
+    CHECK(instance.rewrite_query({"a"}).href() == "https://example.com/?");
+    CHECK(skyr::url("https://example.com/").rewrite_query({"a"}).href() == "https://example.com/");
+  }
+
+  SECTION("without_params") {
+    auto instance = skyr::url("https://example.com/?a=1&b=2&a=3&c=4");
+    CHECK(instance.without_params({"a", "c"}).href() == "https://example.com/?b=2");
+    CHECK(instance.without_params({}).href() == instance.href());
+  }
+}
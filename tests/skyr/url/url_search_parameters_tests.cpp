@@ -3,7 +3,13 @@
 // (See accompanying file LICENSE_1_0.txt of copy at
 // http://www.boost.org/LICENSE_1_0.txt)
 
+#include <cstdint>
 #include <exception>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include <catch2/catch_all.hpp>
 
@@ -354,4 +360,125 @@ TEST_CASE("url") {
     CHECK(value.value() == "\xf0\x9f\x8f\xb3\xef\xb8\x8f\xe2\x80\x8d\xf0\x9f\x8c\x88");
     CHECK("?key=e1f7bc78&q=%F0%9F%8F%B3%EF%B8%8F%E2%80%8D%F0%9F%8C%88" == url.search());
   }
+
+  SECTION("get_all_is_a_view") {
+    auto url = skyr::url("https://example.org/?a=1&b=2&a=3&a");
+    auto values = url.search_parameters().get_all("a");
+    CHECK(std::vector<std::string_view>(values.begin(), values.end()) == std::vector<std::string_view>{"1", "3", ""});
+    CHECK(url.search_parameters().get_all("c").empty());
+  }
+
+  SECTION("get_all_with_a_temporary_name") {
+    auto url = skyr::url("https://example.org/?a=1&b=2&a=3&a");
+    auto values = url.search_parameters().get_all(std::string("a"));
+    auto name = std::string("overwrites the temporary name");
+    CHECK(std::vector<std::string_view>(values.begin(), values.end()) == std::vector<std::string_view>{"1", "3", ""});
+  }
+
+  SECTION("indexed_lookup") {
+    auto query = std::string{};
+    for (auto i = 0; i < 100; ++i) {
+      query += std::format("{}p{}={}", query.empty() ? "" : "&", i % 40, i);
+    }
+    auto url = skyr::url(std::format("https://example.org/?{}", query));
+    auto& parameters = url.search_parameters();
+    REQUIRE(parameters.size() >= skyr::url_search_parameters::index_threshold);
+
+    CHECK(parameters.get("p0") == "0");
+    CHECK(parameters.get("p39") == "39");
+    CHECK_FALSE(parameters.get("p40"));
+    CHECK(parameters.contains("p7"));
+    CHECK_FALSE(parameters.contains("q"));
+    auto values = parameters.get_all("p1");
+    CHECK(std::vector<std::string_view>(values.begin(), values.end()) ==
+          std::vector<std::string_view>{"1", "41", "81"});
+
+    parameters.set("p1", "x");
+    CHECK(parameters.get("p1") == "x");
+    CHECK(std::ranges::distance(parameters.get_all("p1")) == 1);
+    parameters.append("new", "y");
+    CHECK(parameters.get("new") == "y");
+    parameters.remove("p0");
+    CHECK_FALSE(parameters.contains("p0"));
+    CHECK(parameters.get("p2") == "2");
+    parameters.sort();
+    CHECK(std::ranges::distance(parameters.get_all("p39")) == 2);
+    CHECK(parameters.get("new") == "y");
+    parameters.clear();
+    CHECK_FALSE(parameters.contains("p2"));
+  }
+
+  SECTION("indexed_standalone_parameters") {
+    auto parameters = skyr::url_search_parameters{};
+    for (auto i = 0; i < 20; ++i) {
+      parameters.append(std::format("k{}", i), std::format("{}", i));
+    }
+    parameters.append("k3", "again");
+    CHECK(parameters.get("k19") == "19");
+    auto values = parameters.get_all("k3");
+    CHECK(std::vector<std::string_view>(values.begin(), values.end()) == std::vector<std::string_view>{"3", "again"});
+    parameters.remove("k3");
+    CHECK_FALSE(parameters.contains("k3"));
+    CHECK(parameters.get("k4") == "4");
+  }
+
+  SECTION("get_as") {
+    enum class format { json = 1, xml = 2 };
+
+    auto url = skyr::url("https://example.org/?page=3&limit=50&debug=true&ratio=0.25&format=2&name=json&neg=-7");
+    const auto& parameters = url.search_parameters();
+    CHECK(parameters.get_as<int>("page") == 3);
+    CHECK(parameters.get_as<unsigned long>("limit") == 50ul);
+    CHECK(parameters.get_as<bool>("debug") == true);
+    CHECK(parameters.get_as<double>("ratio") == 0.25);
+    CHECK(parameters.get_as<format>("format") == format::xml);
+    CHECK(parameters.get_as<format>("name", {{"json", format::json}, {"xml", format::xml}}) == format::json);
+    CHECK(parameters.get_as<int>("neg") == -7);
+  }
+
+  SECTION("get_as_errors") {
+    auto url = skyr::url("https://example.org/?page=3x&big=300&flag=yes&empty&space=%201");
+    const auto& parameters = url.search_parameters();
+    CHECK(parameters.get_as<int>("missing").error() == skyr::query_value_errc::not_found);
+    CHECK(parameters.get_as<int>("page").error() == skyr::query_value_errc::invalid_value);
+    CHECK(parameters.get_as<std::uint8_t>("big").error() == skyr::query_value_errc::out_of_range);
+    CHECK(parameters.get_as<bool>("flag").error() == skyr::query_value_errc::invalid_value);
+    CHECK(parameters.get_as<int>("empty").error() == skyr::query_value_errc::invalid_value);
+    CHECK(parameters.get_as<int>("space").error() == skyr::query_value_errc::invalid_value);
+  }
+
+  SECTION("get_as_types") {
+    enum class level : char { low = 1, high = 2 };
+
+    static_assert(skyr::query_value<bool>);
+    static_assert(skyr::query_value<signed char>);
+    static_assert(skyr::query_value<std::uint8_t>);
+    static_assert(skyr::query_value<level>);
+    static_assert(!skyr::query_value<char>);
+    static_assert(!skyr::query_value<wchar_t>);
+    static_assert(!skyr::query_value<char8_t>);
+    static_assert(!skyr::query_value<char16_t>);
+    static_assert(!skyr::query_value<char32_t>);
+    static_assert(!skyr::query_value<std::string_view>);
+
+    auto url = skyr::url("https://example.org/?level=2&flag=1");
+    const auto& parameters = url.search_parameters();
+    CHECK(parameters.get_as<level>("level") == level::high);
+    CHECK(parameters.get_as<bool>("flag") == true);
+  }
+
+  SECTION("serialize_to") {
+    auto parameters = skyr::url_search_parameters{{"a b", "c&d"}, {"e", ""}, {"\xcf\x80", "="}};
+    auto expected = std::string_view("a%20b=c%26d&e=&%CF%80=%3D");
+    CHECK(parameters.to_string() == expected);
+    CHECK(parameters.serialized_size() == expected.size());
+
+    auto buffer = std::string("?");
+    parameters.serialize_to(std::back_inserter(buffer));
+    CHECK(buffer.substr(1) == expected);
+
+    CHECK(skyr::url_search_parameters{}.serialized_size() == 0);
+    CHECK(skyr::url_search_parameters{{"flag"}}.to_string() == "flag");
+    CHECK(skyr::url_search_parameters{{"flag"}}.serialized_size() == 4);
+  }
 }
@@ -4,8 +4,20 @@
 # http://www.boost.org/LICENSE_1_0.txt)
 
 # This script parses the IDNA table from
-# https://unicode.org/Public/idna/11.0.0/IdnaMappingTable.txt,
-# and converts it to a C++ table.
+# https://www.unicode.org/Public/idna/latest/IdnaMappingTable.txt,
+# and converts it to C++ tables.
+#
+# The status and the mapping index of each code point are stored in
+# three-stage tables: the code point is split into a block index, an
+# index into the block and an offset, and identical blocks are stored
+# once. A lookup takes three loads, and the block sizes are chosen to
+# make the tables as small as possible.
+#
+# A mapping can have more than one code point (e.g. U+0133 maps to "ij"),
+# so each mapping index selects an offset and a length in a pool of code
+# points, and mappings that are contained in another share its storage.
+#
+# Usage: make_idna_table.py IdnaMappingTable.txt idna_tables.hpp
 
 
 import sys
@@ -15,20 +27,21 @@ import jinja2
 def parse_line(line):
     line = line[0:line.find('#')]
     tokens = [token.strip() for token in line.split(';')] if line else []
-    if len(tokens) == 3:
-        tokens[2] = tokens[2].split(' ')[0]
     return tokens
 
 
-status_keys = [
-    'valid',
-    'mapped',
-    'disallowed',
-    'disallowed_STD3_valid',
-    'disallowed_STD3_mapped',
-    'ignored',
-    'deviation',
-    ]
+# The values of skyr::idna::idna_status
+status_keys = {
+    'disallowed': 1,
+    'disallowed_STD3_valid': 2,
+    'disallowed_STD3_mapped': 3,
+    'ignored': 4,
+    'mapped': 5,
+    'deviation': 6,
+    'valid': 7,
+    }
+
+code_point_count = 0x110000
 
 
 class CodePointRange(object):
@@ -40,19 +53,78 @@ class CodePointRange(object):
             range = [int(range[0], 16), int(range[1], 16)]
         self.range = range
         self.status = status
-        self.mapped = int(mapped, 16) if mapped else None
+        self.mapped = tuple(int(value, 16) for value in mapped.split()) if mapped is not None else None
 
     @property
     def is_mapped(self):
-        return self.status in ('mapped', 'disallowed_STD3_mapped')
+        return self.status in ('mapped', 'disallowed_STD3_mapped', 'deviation')
 
-    @property
-    def is_valid(self):
-        return self.status == 'valid'
+
+class ThreeStageTable(object):
+    """Splits a value for each code point into deduplicated blocks."""
+
+    def __init__(self, values, leaf_shift, index_shift):
+        self.leaf_shift = leaf_shift
+        self.index_shift = index_shift
+
+        leaf_size = 1 << leaf_shift
+        leaves, leaf_indices = {}, []
+        for first in range(0, len(values), leaf_size):
+            leaf = tuple(values[first:first + leaf_size])
+            leaf_indices.append(leaves.setdefault(leaf, len(leaves)))
+
+        index_size = 1 << index_shift
+        blocks, block_indices = {}, []
+        for first in range(0, len(leaf_indices), index_size):
+            block = tuple(leaf_indices[first:first + index_size])
+            block_indices.append(blocks.setdefault(block, len(blocks)))
+
+        self.stage_1 = block_indices
+        self.stage_2 = [index for block in blocks for index in block]
+        self.stage_3 = [value for leaf in leaves for value in leaf]
 
     @property
-    def can_be_16_bit(self):
-        return self.range[0] <= 0xffff and self.mapped is not None and self.mapped <= 0xffff
+    def size(self):
+        return sum(len(stage) * element_size(stage) for stage in (self.stage_1, self.stage_2, self.stage_3))
+
+    @staticmethod
+    def smallest(values):
+        tables = [ThreeStageTable(values, leaf_shift, index_shift)
+                  for leaf_shift in range(3, 9) for index_shift in range(2, 9)]
+        return min(tables, key=lambda table: table.size)
+
+
+def element_size(values):
+    return 1 if max(values) <= 0xff else 2 if max(values) <= 0xffff else 4
+
+
+def element_type(values):
+    return {1: 'std::uint8_t', 2: 'std::uint16_t', 4: 'char32_t'}[element_size(values)]
+
+
+def make_pool(mappings):
+    """Concatenates the mappings, storing a mapping once if it's contained in a longer one."""
+    pool, offsets = '', {}
+    for mapping in sorted(mappings, key=len, reverse=True):
+        text = ''.join(chr(value) for value in mapping)
+        offset = pool.find(text)
+        if offset < 0:
+            offset, pool = len(pool), pool + text
+        offsets[mapping] = offset
+    return [ord(value) for value in pool], offsets
+
+
+def format_values(values, format='{}', indent=4, width=120):
+    """Formats array elements as lines that are at most `width` columns wide."""
+    lines, line = [], ''
+    for value in values:
+        item = format.format(value) + ','
+        if line and len(line) + len(item) + 1 > width - indent:
+            lines.append(line)
+            line = ''
+        line = line + ' ' + item if line else item
+    lines.append(line)
+    return '\n'.join(' ' * indent + line for line in lines)
 
 
 def main():
@@ -66,16 +138,26 @@ def main():
                 code_points.append(CodePointRange(
                     code_point[0], code_point[1], code_point[2] if len(code_point) > 2 else None))
 
-        # Store code point mappings as std::char16_t if they can, otherwise store them as std::char32_t
-        mapped_code_points_16, mapped_code_points_32 = [], []
-        for code_point in filter(lambda cp: cp.is_mapped, code_points):
-            (mapped_code_points_32, mapped_code_points_16)[code_point.can_be_16_bit].append(code_point)
+        # Code points that aren't in the table are valid. Mapping index 0 means that the code point isn't mapped,
+        # which is different to a deviation that is mapped to an empty string.
+        statuses = [status_keys['valid']] * code_point_count
+        mappings, mapped_indices = {None: 0}, [0] * code_point_count
+        for code_point in code_points:
+            for value in range(code_point.range[0], code_point.range[1] + 1):
+                statuses[value] = status_keys[code_point.status]
+                if code_point.is_mapped:
+                    mapped_indices[value] = mappings.setdefault(code_point.mapped, len(mappings))
 
-        # Squeeze code points to reduce table size, and remove all valid code points as they will be handled by default
-        code_points = [code_point for code_point in code_points if not code_point.is_valid]
+        mappings = sorted(mappings, key=mappings.get)[1:]
+        mapped_pool, pool_offsets = make_pool(mappings)
+        mapped_offsets = [0] + [pool_offsets[mapping] for mapping in mappings]
+        mapped_lengths = [0] + [len(mapping) for mapping in mappings]
+
+        status_table = ThreeStageTable.smallest(statuses)
+        mapped_table = ThreeStageTable.smallest(mapped_indices)
 
         template = jinja2.Template(
-            """// Auto-generated.
+            """// Auto-generated by tools/make_idna_table.py.
 // Distributed under the Boost Software License, Version 1.0.
 // (See accompanying file LICENSE_1_0.txt or copy at
 // http://www.boost.org/LICENSE_1_0.txt)
@@ -83,49 +165,56 @@ def main():
 #ifndef SKYR_DOMAIN_IDNA_TABLES_HPP
 #define SKYR_DOMAIN_IDNA_TABLES_HPP
 
-#include <algorithm>
 #include <array>
-#include <iterator>
-#include <skyr/domain/idna_status.hpp>
+#include <cstdint>
 
 namespace skyr::idna::details {
-struct code_point_range {
-  char32_t first;
-  char32_t last;
-  idna_status status;
-};
-
-constexpr static auto statuses = std::array<code_point_range, {{ entries|length }}>{% raw %}{{{% endraw %}
-{% for code_point in entries %}  { U'\\x{{ '%04x' % code_point.range[0] }}', U'\\x{{ '%04x' % code_point.range[1] }}', idna_status::{{ code_point.status.lower() }} },
-{% endfor %}{% raw %}}}{% endraw %};
-
-struct mapped_16_code_point {
-  char16_t code_point;
-  char16_t mapped;
-};
-
-constexpr static auto mapped_16 = std::array<mapped_16_code_point, {{ mapped_entries_16|length }}>{% raw %}{{{% endraw %}
-{% for code_point in mapped_entries_16 %}  { U'\\x{{ '%04x' % code_point.range[0] }}', U'\\x{{ '%04x' % code_point.mapped }}' },
-{% endfor %}{% raw %}}}{% endraw %};
-
-struct mapped_32_code_point {
-  char32_t code_point;
-  char32_t mapped;
-};
-
-constexpr static auto mapped_32 = std::array<mapped_32_code_point, {{ mapped_entries_32|length }}>{% raw %}{{{% endraw %}
-{% for code_point in mapped_entries_32 %}  { U'\\x{{ '%04x' % code_point.range[0] }}', U'\\x{{ '%04x' % code_point.mapped }}' },
-{% endfor %}{% raw %}}}{% endraw %};
+{%- for name, description, table in tables %}
+/// {{ description }}
+inline constexpr auto {{ name }}_leaf_shift = {{ table.leaf_shift }}u;
+inline constexpr auto {{ name }}_index_shift = {{ table.index_shift }}u;
+
+constexpr static auto {{ name }}_stage_1 = std::array<{{ element_type(table.stage_1) }}, {{ table.stage_1|length }}>{% raw %}{{{% endraw %}
+{{ format_values(table.stage_1) }}
+{% raw %}}}{% endraw %};
+
+constexpr static auto {{ name }}_stage_2 = std::array<{{ element_type(table.stage_2) }}, {{ table.stage_2|length }}>{% raw %}{{{% endraw %}
+{{ format_values(table.stage_2) }}
+{% raw %}}}{% endraw %};
+
+constexpr static auto {{ name }}_stage_3 = std::array<{{ element_type(table.stage_3) }}, {{ table.stage_3|length }}>{% raw %}{{{% endraw %}
+{{ format_values(table.stage_3) }}
+{% raw %}}}{% endraw %};
+{% endfor %}
+/// The offset in `mapped_pool` of each mapping, where index 0 means that the code point isn't mapped
+constexpr static auto mapped_offsets = std::array<{{ element_type(mapped_offsets) }}, {{ mapped_offsets|length }}>{% raw %}{{{% endraw %}
+{{ format_values(mapped_offsets) }}
+{% raw %}}}{% endraw %};
+
+/// The number of code points in each mapping
+constexpr static auto mapped_lengths = std::array<{{ element_type(mapped_lengths) }}, {{ mapped_lengths|length }}>{% raw %}{{{% endraw %}
+{{ format_values(mapped_lengths) }}
+{% raw %}}}{% endraw %};
+
+/// The code points of every mapping
+constexpr static auto mapped_pool = std::array<char32_t, {{ mapped_pool|length }}>{% raw %}{{{% endraw %}
+{{ format_values(mapped_pool, "U'\\\\x{:04x}'") }}
+{% raw %}}}{% endraw %};
 }  // namespace skyr::idna::details
 
 #endif  // SKYR_DOMAIN_IDNA_TABLES_HPP
-
 """)
 
         template.stream(
-            entries=code_points,
-            mapped_entries_16=mapped_code_points_16,
-            mapped_entries_32=mapped_code_points_32
+            tables=[
+                ('status', 'The status of each code point, as a three-stage table', status_table),
+                ('mapped', 'The mapping index of each code point, as a three-stage table', mapped_table),
+            ],
+            mapped_offsets=mapped_offsets,
+            mapped_lengths=mapped_lengths,
+            mapped_pool=mapped_pool,
+            element_type=element_type,
+            format_values=format_values,
         ).dump(output_file)
 
 
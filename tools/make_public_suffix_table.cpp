@@ -0,0 +1,104 @@
+// Copyright 2025 Glyn Matthews.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+// This program compiles a public suffix list from
+// https://publicsuffix.org/list/public_suffix_list.dat into a header, so
+// that the list is compiled once, at build time, and lookups use tables
+// that are in the program's read only data.
+//
+// Usage: make_public_suffix_table public_suffix_list.dat public_suffix_table.hpp
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+
+#include <skyr/public_suffix/public_suffix_list.hpp>
+
+namespace {
+// The values are wrapped in rows of this many entries
+constexpr auto values_per_row = 8;
+
+void write_table(std::ostream& os, const skyr::public_suffix_list& list, std::string_view source) {
+  os << "// Auto-generated by tools/make_public_suffix_table.cpp from " << source << ".\n"
+     << "// Do not edit.\n\n"
+     << "#ifndef SKYR_PUBLIC_SUFFIX_PUBLIC_SUFFIX_TABLE_HPP\n"
+     << "#define SKYR_PUBLIC_SUFFIX_PUBLIC_SUFFIX_TABLE_HPP\n\n"
+     << "#include <array>\n"
+     << "#include <cstdint>\n"
+     << "#include <string_view>\n\n"
+     << "#include <skyr/public_suffix/public_suffix_list.hpp>\n\n"
+     << "namespace skyr {\n"
+     << "namespace public_suffix_table {\n";
+
+  os << "inline constexpr auto nodes = std::array<public_suffix_node, " << list.nodes().size() << ">{{";
+  auto column = 0;
+  for (const auto& node : list.nodes()) {
+    os << ((column++ % values_per_row == 0) ? "\n    " : " ") << "{" << node.first_edge << ", " << node.edge_count
+       << ", " << static_cast<unsigned>(node.flags) << "},";
+  }
+  os << "\n}};\n\n";
+
+  os << "inline constexpr auto edges = std::array<public_suffix_edge, " << list.edges().size() << ">{{";
+  column = 0;
+  for (const auto& edge : list.edges()) {
+    os << ((column++ % values_per_row == 0) ? "\n    " : " ") << "{" << edge.label_offset << ", " << edge.label_length
+       << ", " << edge.node << "},";
+  }
+  os << "\n}};\n\n";
+
+  // Written as characters rather than a string literal, because the label pool is longer than some compilers allow
+  // string literals to be
+  os << "inline constexpr auto labels = std::array<char, " << list.labels().size() << ">{";
+  column = 0;
+  for (auto byte : list.labels()) {
+    os << ((column++ % (values_per_row * 2) == 0) ? "\n    " : " ") << "'"
+       << (((byte == '\'') || (byte == '\\')) ? "\\" : "") << byte << "',";
+  }
+  os << "\n};\n\n";
+
+  os << "inline constexpr auto index = std::array<std::uint32_t, " << list.index().size() << ">{";
+  column = 0;
+  for (auto edge : list.index()) {
+    os << ((column++ % (values_per_row * 2) == 0) ? "\n    " : " ") << edge << "u,";
+  }
+  os << "\n};\n"
+     << "}  // namespace public_suffix_table\n\n"
+     << "/// \\returns The public suffix list that was compiled into this header\n"
+     << "inline auto compiled_public_suffix_list() noexcept -> public_suffix_list {\n"
+     << "  return public_suffix_list(\n"
+     << "      public_suffix_table::nodes, public_suffix_table::edges,\n"
+     << "      std::string_view(public_suffix_table::labels.data(), public_suffix_table::labels.size()),\n"
+     << "      public_suffix_table::index);\n"
+     << "}\n"
+     << "}  // namespace skyr\n\n"
+     << "#endif  // SKYR_PUBLIC_SUFFIX_PUBLIC_SUFFIX_TABLE_HPP\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " public_suffix_list.dat public_suffix_table.hpp\n";
+    return 1;
+  }
+
+  auto list = skyr::public_suffix_list::load(argv[1]);
+  if (!list) {
+    std::cerr << "Unable to compile " << argv[1] << " (error " << static_cast<int>(list.error()) << ")\n";
+    return 1;
+  }
+
+  auto output_path = std::filesystem::path(argv[2]);
+  if (output_path.has_parent_path()) {
+    std::filesystem::create_directories(output_path.parent_path());
+  }
+  auto output = std::ofstream(output_path);
+  write_table(output, list.value(), std::filesystem::path(argv[1]).filename().string());
+  if (!output) {
+    std::cerr << "Unable to write " << argv[2] << "\n";
+    return 1;
+  }
+  return 0;
+}